@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "events.cpp"
+
+// Сводная статистика по бинарному журналу партий (./main.out --sim ... events.bin).
+// Журнал отображается в память, партии раздаются потокам кусками через атомарный счётчик,
+// каждый поток копит свою Analytics, после join они складываются — без блокировок.
+
+struct RoleStats
+{
+    uint64_t players = 0;        // сколько раз роль была в партии
+    uint64_t wins = 0;           // её команда победила
+    uint64_t survived = 0;       // дожила до конца
+    uint64_t hanged = 0;         // повешена днём
+    uint64_t killed = 0;         // убита ночью
+    uint64_t kills = 0;          // убила ночью сама
+    uint64_t votes = 0;          // голосов отдано
+    uint64_t votes_on_enemy = 0; // из них — против чужой команды
+
+    RoleStats &operator+=(const RoleStats &o)
+    {
+        players += o.players;
+        wins += o.wins;
+        survived += o.survived;
+        hanged += o.hanged;
+        killed += o.killed;
+        kills += o.kills;
+        votes += o.votes;
+        votes_on_enemy += o.votes_on_enemy;
+        return *this;
+    }
+};
+
+struct alignas(64) Analytics
+{
+    std::array<RoleStats, size_t(Role::Count)> roles{};
+    std::array<uint64_t, size_t(Team::Count)> outcomes{};
+    uint64_t games = 0;
+    uint64_t days = 0;
+    uint64_t checks = 0, checks_found_mafia = 0;
+    uint64_t heals = 0, heals_saved = 0;
+
+    // рабочие массивы на партию, переиспользуются между партиями
+    std::vector<Role> role_of;
+    std::vector<uint8_t> alive;
+
+    void add_game(const GameRecord &game)
+    {
+        size_t n = game.header->players;
+        role_of.assign(n, Role::Civilian);
+        alive.assign(n, 1);
+        Team outcome = Team::Draw;
+
+        for (const Event &e : game.events)
+        {
+            switch (e.type)
+            {
+            case EventType::RoleAssigned:
+                if (e.actor < n && e.arg < size_t(Role::Count))
+                    role_of[e.actor] = Role(e.arg);
+                break;
+            case EventType::Vote:
+                if (e.actor < n && e.target < n)
+                {
+                    auto &rs = roles[size_t(role_of[e.actor])];
+                    rs.votes++;
+                    rs.votes_on_enemy += team_of(role_of[e.actor]) != team_of(role_of[e.target]);
+                }
+                break;
+            case EventType::Hanged:
+                if (e.target < n)
+                {
+                    roles[size_t(role_of[e.target])].hanged++;
+                    alive[e.target] = 0;
+                }
+                break;
+            case EventType::Kill:
+                if (e.actor < n)
+                    roles[size_t(role_of[e.actor])].kills++;
+                // на одного убитого может быть несколько событий (по числу напавших)
+                if (e.target < n && alive[e.target])
+                {
+                    roles[size_t(role_of[e.target])].killed++;
+                    alive[e.target] = 0;
+                }
+                break;
+            case EventType::Check:
+                checks++;
+                checks_found_mafia += e.arg < size_t(Role::Count) && team_of(Role(e.arg)) == Team::Mafia;
+                break;
+            case EventType::Heal:
+                heals++;
+                heals_saved += e.arg != 0;
+                break;
+            case EventType::GameEnd:
+                if (e.arg < size_t(Team::Count))
+                    outcome = Team(e.arg);
+                days += uint64_t(e.day) + 1;
+                break;
+            default:
+                break;
+            }
+        }
+
+        games++;
+        outcomes[size_t(outcome)]++;
+        for (size_t p = 0; p < n; p++)
+        {
+            auto &rs = roles[size_t(role_of[p])];
+            rs.players++;
+            rs.survived += alive[p];
+            rs.wins += team_of(role_of[p]) == outcome;
+        }
+    }
+
+    Analytics &operator+=(const Analytics &o)
+    {
+        for (size_t r = 0; r < roles.size(); r++)
+            roles[r] += o.roles[r];
+        for (size_t t = 0; t < outcomes.size(); t++)
+            outcomes[t] += o.outcomes[t];
+        games += o.games;
+        days += o.days;
+        checks += o.checks;
+        checks_found_mafia += o.checks_found_mafia;
+        heals += o.heals;
+        heals_saved += o.heals_saved;
+        return *this;
+    }
+};
+
+static double percent(uint64_t part, uint64_t whole)
+{
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+}
+
+static void print_report(const Analytics &a, double seconds, unsigned int threads)
+{
+    std::cout << "Партий: " << a.games << ", потоков: " << threads << ", " << std::fixed << std::setprecision(3)
+              << seconds << " с (" << std::setprecision(0) << (seconds > 0 ? a.games / seconds : 0.0) << " партий/с)" << std::endl;
+    std::cout << std::setprecision(2);
+    for (size_t t = 0; t < a.outcomes.size(); t++)
+        std::cout << team_name(Team(t)) << ": " << a.outcomes[t] << " (" << percent(a.outcomes[t], a.games) << "%)" << std::endl;
+    std::cout << "Средняя длина партии: " << (a.games ? double(a.days) / a.games : 0.0) << " дн." << std::endl;
+    std::cout << "Комиссар: проверок " << a.checks << ", найдено мафии " << percent(a.checks_found_mafia, a.checks) << "%" << std::endl;
+    std::cout << "Доктор: лечений " << a.heals << ", спасений " << percent(a.heals_saved, a.heals) << "%" << std::endl;
+
+    std::cout << std::endl
+              // заголовки латиницей: setw считает байты, а не символы
+              << std::left << std::setw(12) << "role" << std::right
+              << std::setw(12) << "players" << std::setw(9) << "win%" << std::setw(9) << "alive%"
+              << std::setw(9) << "hanged%" << std::setw(9) << "killed%" << std::setw(10) << "kills"
+              << std::setw(11) << "vs_enemy%" << std::endl;
+    for (size_t r = 0; r < a.roles.size(); r++)
+    {
+        const RoleStats &rs = a.roles[r];
+        if (rs.players == 0)
+            continue;
+        std::cout << std::left << std::setw(12) << role_name(Role(r)) << std::right
+                  << std::setw(12) << rs.players
+                  << std::setw(9) << percent(rs.wins, rs.players)
+                  << std::setw(9) << percent(rs.survived, rs.players)
+                  << std::setw(9) << percent(rs.hanged, rs.players)
+                  << std::setw(9) << percent(rs.killed, rs.players)
+                  << std::setw(10) << rs.kills
+                  << std::setw(11) << percent(rs.votes_on_enemy, rs.votes) << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Использование: " << argv[0] << " events.bin [threads]" << std::endl;
+        return 1;
+    }
+    unsigned int threads = argc > 2 ? std::stoul(argv[2]) : 0;
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto start = std::chrono::steady_clock::now();
+    EventLogView log_view(argv[1]);
+    if (!log_view.ok())
+    {
+        std::cerr << "Не удалось открыть журнал " << argv[1] << std::endl;
+        return 1;
+    }
+    const std::vector<size_t> &offsets = log_view.index();
+
+    constexpr size_t chunk = 4096;
+    std::atomic<size_t> next{0};
+    std::vector<Analytics> per_thread(threads);
+    auto worker = [&](Analytics &local)
+    {
+        for (;;)
+        {
+            size_t begin = next.fetch_add(chunk, std::memory_order_relaxed);
+            if (begin >= offsets.size())
+                break;
+            size_t end = std::min(offsets.size(), begin + chunk);
+            for (size_t i = begin; i < end; i++)
+            {
+                GameRecord game;
+                if (log_view.game_at(offsets[i], game))
+                    local.add_game(game);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(worker, std::ref(per_thread[t]));
+    worker(per_thread[0]);
+    for (auto &th : pool)
+        th.join();
+
+    Analytics total;
+    for (const auto &a : per_thread)
+        total += a;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    print_report(total, seconds, threads);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// Подключается и из main.cpp, и из scheduler.cpp
+#ifndef MAFIA_ARENA_CPP
+#define MAFIA_ARENA_CPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Арена партии: память берётся у системы кусками и раздаётся сдвигом указателя.
+// Вся память возвращается разом в деструкторе — в конце партии, без free на каждый объект.
+// Мелкие блоки, которые освобождаются и снова нужны каждый ход (кадры корутин),
+// deallocate кладёт в список свободных своего класса размера, и следующий ход берёт их оттуда.
+// Не потокобезопасна: одна партия — один поток
+class Arena
+{
+public:
+    explicit Arena(size_t chunk_bytes = 16 * 1024) : chunk_size(chunk_bytes) {}
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena()
+    {
+        while (chunks)
+        {
+            Chunk *next = chunks->next;
+            ::operator delete(chunks);
+            chunks = next;
+        }
+    }
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t))
+    {
+        if (pooled(size, align))
+        {
+            size_t cls = size_class(size);
+            if (FreeNode *node = free_lists[cls])
+            {
+                free_lists[cls] = node->next;
+                return node;
+            }
+            size = cls * kGranule; // блок подойдёт любому запросу своего класса
+        }
+
+        uintptr_t p = align_up(cur, align);
+        if (p + size > end)
+        {
+            grow(size + align);
+            p = align_up(cur, align);
+        }
+        cur = p + size;
+        return reinterpret_cast<void *>(p);
+    }
+
+    // Крупные блоки остаются до конца партии
+    void deallocate(void *p, size_t size, size_t align = alignof(std::max_align_t)) noexcept
+    {
+        if (!p || !pooled(size, align))
+            return;
+        size_t cls = size_class(size);
+        free_lists[cls] = ::new (p) FreeNode{free_lists[cls]};
+    }
+
+    // Сколько памяти взято у системы
+    size_t reserved() const { return reserved_bytes; }
+
+private:
+    static constexpr size_t kGranule = alignof(std::max_align_t);
+    static constexpr size_t kMaxPooled = 1024;
+
+    struct Chunk
+    {
+        Chunk *next;
+    };
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    static bool pooled(size_t size, size_t align) { return size <= kMaxPooled && align <= kGranule; }
+    static size_t size_class(size_t size) { return (size + kGranule - 1) / kGranule; }
+    static uintptr_t align_up(uintptr_t p, size_t align) { return (p + align - 1) & ~uintptr_t(align - 1); }
+
+    void grow(size_t need)
+    {
+        size_t header = (sizeof(Chunk) + kGranule - 1) / kGranule * kGranule;
+        size_t bytes = header + (need > chunk_size ? need : chunk_size);
+        auto chunk = static_cast<Chunk *>(::operator new(bytes));
+        chunk->next = chunks;
+        chunks = chunk;
+        reserved_bytes += bytes;
+        cur = reinterpret_cast<uintptr_t>(chunk) + header;
+        end = reinterpret_cast<uintptr_t>(chunk) + bytes;
+    }
+
+    size_t chunk_size;
+    Chunk *chunks = nullptr;
+    uintptr_t cur = 0;
+    uintptr_t end = 0;
+    size_t reserved_bytes = 0;
+    std::array<FreeNode *, kMaxPooled / kGranule + 1> free_lists{};
+};
+
+#endif // MAFIA_ARENA_CPP
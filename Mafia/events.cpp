@@ -0,0 +1,356 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "game_state.cpp"
+
+// Бинарный журнал партий: вместо текста в logs/*.log — поток событий фиксированного размера.
+// Файл: FileHeader, затем блоки партий (GameHeader + event_count событий по 8 байт).
+// Партия самодостаточна: в ней записаны сид и исходный список ролей (Setup),
+// поэтому её можно переиграть без config.yaml и сравнить события один в один.
+
+enum class EventType : uint8_t
+{
+    Setup,           // actor = позиция в исходном списке ролей, arg = роль
+    RoleAssigned,    // actor = игрок, arg = роль
+    BossElected,     // actor = новый босс мафии
+    DayStart,        // day = номер дня
+    Vote,            // actor голосует за target
+    Hanged,          // target повешен, arg = число голосов
+    Check,           // комиссар проверил target, arg = роль target
+    Heal,            // доктор вылечил target, arg = 1, если снял покушение
+    JournalistCheck, // actor и target сравнены, arg = 1, если в одной команде
+    FanCheck,        // поклонница проверила target, arg = 1, если это комиссар
+    Kill,            // actor убил target ночью (по событию на каждого напавшего)
+    GameEnd,         // arg = Team-исход, day = последний день партии
+};
+
+inline constexpr uint16_t kNobody = 0xFFFF;
+
+struct Event
+{
+    EventType type;
+    uint8_t day;
+    uint16_t actor;
+    uint16_t target;
+    uint16_t arg;
+
+    bool operator==(const Event &) const = default;
+};
+static_assert(sizeof(Event) == 8);
+
+struct EventFileHeader
+{
+    char magic[8];    // "MFEVLOG1"
+    uint32_t version;
+    uint32_t reserved;
+};
+static_assert(sizeof(EventFileHeader) == 16);
+
+struct GameHeader
+{
+    uint32_t magic; // kGameMagic
+    uint16_t players;
+    uint16_t reserved;
+    uint32_t event_count;
+    uint32_t reserved2;
+    uint64_t seed;  // сид генератора партии (game_seed(base, index))
+    uint64_t index; // номер партии в серии
+};
+static_assert(sizeof(GameHeader) == 32);
+
+inline constexpr char kEventFileMagic[8] = {'M', 'F', 'E', 'V', 'L', 'O', 'G', '1'};
+inline constexpr uint32_t kEventFileVersion = 1;
+inline constexpr uint32_t kGameMagic = 0x4D474D46; // "FMGM"
+
+// События одной партии; Game пишет сюда, если recorder задан
+struct EventRecorder
+{
+    GameHeader header{};
+    std::vector<Event> events;
+    uint8_t day = 0;
+
+    void begin(uint64_t seed, uint64_t index, unsigned int players)
+    {
+        header = GameHeader{kGameMagic, uint16_t(players), 0, 0, 0, seed, index};
+        events.clear();
+        day = 0;
+    }
+
+    void add(EventType type, size_t actor = kNobody, size_t target = kNobody, unsigned int arg = 0)
+    {
+        events.push_back(Event{type, day, uint16_t(actor), uint16_t(target), uint16_t(arg)});
+    }
+
+    void start_day(unsigned int number)
+    {
+        day = uint8_t(number > 255 ? 255 : number);
+        add(EventType::DayStart);
+    }
+};
+
+// Дописывает партии пачками в файл, созданный create_event_log. Файл открыт с O_APPEND,
+// каждая пачка уходит одним write, поэтому несколько потоков со своими EventLogWriter
+// пишут в один файл без блокировок; порядок партий произвольный, ищут по GameHeader::index.
+// Короткую запись не дописываем вторым write — между ними вклинился бы чужой поток;
+// такая пачка считается потерянной, writer переходит в failed(), а читатель пропускает обрывок
+// (EventLogView::index ищет следующий заголовок)
+class EventLogWriter
+{
+public:
+    explicit EventLogWriter(const std::string &path, size_t batch_bytes = 1 << 20) : batch_limit(batch_bytes)
+    {
+        fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+
+    EventLogWriter(const EventLogWriter &) = delete;
+    EventLogWriter &operator=(const EventLogWriter &) = delete;
+
+    ~EventLogWriter()
+    {
+        flush();
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    bool ok() const { return fd >= 0; }
+    // Была ли потеряна хоть одна пачка (или журнал не открылся)
+    bool failed() const { return write_failed || fd < 0; }
+
+    void write_game(EventRecorder &rec)
+    {
+        rec.header.event_count = uint32_t(rec.events.size());
+        append(&rec.header, sizeof(rec.header));
+        append(rec.events.data(), rec.events.size() * sizeof(Event));
+        if (buffer.size() >= batch_limit)
+            flush();
+    }
+
+    // false, если пачка не легла в файл целиком
+    bool flush()
+    {
+        if (buffer.empty())
+            return !failed();
+        ssize_t n;
+        do
+            n = fd >= 0 ? ::write(fd, buffer.data(), buffer.size()) : -1;
+        while (n < 0 && errno == EINTR);
+        if (n != ssize_t(buffer.size()))
+            write_failed = true;
+        buffer.clear();
+        return !failed();
+    }
+
+private:
+    void append(const void *data, size_t n)
+    {
+        auto p = static_cast<const char *>(data);
+        buffer.insert(buffer.end(), p, p + n);
+    }
+
+    int fd = -1;
+    bool write_failed = false;
+    size_t batch_limit;
+    std::vector<char> buffer;
+};
+
+// Создаёт пустой журнал с заголовком (перезаписывая старый), чтобы потоки-писатели только дописывали
+inline bool create_event_log(const std::string &path)
+{
+    ::unlink(path.c_str());
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    EventFileHeader fh{};
+    std::memcpy(fh.magic, kEventFileMagic, sizeof(fh.magic));
+    fh.version = kEventFileVersion;
+    bool ok = ::write(fd, &fh, sizeof(fh)) == ssize_t(sizeof(fh));
+    ::close(fd);
+    return ok;
+}
+
+struct GameRecord
+{
+    const GameHeader *header;
+    std::span<const Event> events;
+};
+
+// Журнал, отображённый в память (только чтение). index() один раз проходит по заголовкам партий;
+// дальше партии читаются напрямую из отображения в любом порядке и из любого потока
+class EventLogView
+{
+public:
+    explicit EventLogView(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(EventFileHeader))
+        {
+            void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                base = static_cast<const char *>(p);
+                size = size_t(st.st_size);
+                madvise(p, size, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        if (base && std::memcmp(base, kEventFileMagic, sizeof(kEventFileMagic)) != 0)
+            unmap();
+    }
+
+    EventLogView(const EventLogView &) = delete;
+    EventLogView &operator=(const EventLogView &) = delete;
+    ~EventLogView() { unmap(); }
+
+    bool ok() const { return base != nullptr; }
+
+    // Смещения всех целых партий. Обрывок недописанной пачки (короткий write посреди файла
+    // или в хвосте) пропускается: ищем следующий заголовок с kGameMagic, который целиком
+    // помещается в файл. Кандидаты проверяем с шагом alignof(GameHeader) — все пачки кратны 8 байтам
+    const std::vector<size_t> &index()
+    {
+        if (!offsets.empty() || !base)
+            return offsets;
+        size_t pos = sizeof(EventFileHeader);
+        while (pos + sizeof(GameHeader) <= size)
+        {
+            size_t next = game_end(pos);
+            if (next == 0)
+            {
+                pos += alignof(GameHeader);
+                continue;
+            }
+            offsets.push_back(pos);
+            pos = next;
+        }
+        return offsets;
+    }
+
+    // false, если по offset нет целой партии
+    bool game_at(size_t offset, GameRecord &out) const
+    {
+        if (game_end(offset) == 0)
+            return false;
+        auto h = reinterpret_cast<const GameHeader *>(base + offset);
+        auto ev = reinterpret_cast<const Event *>(base + offset + sizeof(GameHeader));
+        out = GameRecord{h, std::span<const Event>(ev, h->event_count)};
+        return true;
+    }
+
+    // Поиск партии по номеру в серии
+    bool find(uint64_t game_index, GameRecord &out)
+    {
+        for (size_t off : index())
+        {
+            GameRecord g;
+            if (game_at(off, g) && g.header->index == game_index)
+            {
+                out = g;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // Конец партии по offset или 0, если там нет выровненного заголовка или партия не помещается
+    size_t game_end(size_t offset) const
+    {
+        if (!base || offset % alignof(GameHeader) != 0 || offset < sizeof(EventFileHeader) ||
+            offset > size || size - offset < sizeof(GameHeader))
+            return 0;
+        auto h = reinterpret_cast<const GameHeader *>(base + offset);
+        if (h->magic != kGameMagic)
+            return 0;
+        size_t body = size_t(h->event_count) * sizeof(Event);
+        if (body > size - offset - sizeof(GameHeader))
+            return 0;
+        return offset + sizeof(GameHeader) + body;
+    }
+
+    void unmap()
+    {
+        if (base)
+            munmap(const_cast<char *>(base), size);
+        base = nullptr;
+        size = 0;
+    }
+
+    const char *base = nullptr;
+    size_t size = 0;
+    std::vector<size_t> offsets;
+};
+
+// Исходный список ролей партии (из событий Setup) — то, что передавалось в init_players
+inline std::vector<std::string> setup_roles(const GameRecord &game)
+{
+    std::vector<std::string> roles;
+    for (const Event &e : game.events)
+    {
+        if (e.type == EventType::Setup)
+            roles.push_back(role_name(Role(e.arg)));
+    }
+    return roles;
+}
+
+// Текстовый пересказ партии по событиям (для --replay)
+inline void print_game(const GameRecord &game, std::ostream &os)
+{
+    os << "Партия #" << game.header->index << ", сид " << game.header->seed
+       << ", игроков " << game.header->players << ", событий " << game.events.size() << std::endl;
+    for (const Event &e : game.events)
+    {
+        switch (e.type)
+        {
+        case EventType::Setup:
+            break;
+        case EventType::RoleAssigned:
+            os << "  игрок " << e.actor << " — " << role_name(Role(e.arg)) << std::endl;
+            break;
+        case EventType::BossElected:
+            os << "  [день " << int(e.day) << "] босс мафии — игрок " << e.actor << std::endl;
+            break;
+        case EventType::DayStart:
+            os << "ДЕНЬ " << int(e.day) << std::endl;
+            break;
+        case EventType::Vote:
+            os << "  игрок " << e.actor << " голосует за игрока " << e.target << std::endl;
+            break;
+        case EventType::Hanged:
+            os << "  игрок " << e.target << " повешен (" << e.arg << " голосов)" << std::endl;
+            break;
+        case EventType::Check:
+            os << "  ночь: комиссар проверил игрока " << e.target << " (" << role_name(Role(e.arg)) << ")" << std::endl;
+            break;
+        case EventType::Heal:
+            os << "  ночь: доктор вылечил игрока " << e.target << (e.arg ? " и спас его" : "") << std::endl;
+            break;
+        case EventType::JournalistCheck:
+            os << "  ночь: журналист сравнил игроков " << e.actor << " и " << e.target
+               << (e.arg ? " — одна команда" : " — разные команды") << std::endl;
+            break;
+        case EventType::FanCheck:
+            os << "  ночь: поклонница проверила игрока " << e.target << (e.arg ? " — комиссар" : "") << std::endl;
+            break;
+        case EventType::Kill:
+            os << "  ночь: игрок " << e.target << " убит игроком " << e.actor << std::endl;
+            break;
+        case EventType::GameEnd:
+            os << "ИТОГ: " << team_name(Team(e.arg)) << ", дней " << int(e.day) + 1 << std::endl;
+            break;
+        }
+    }
+}
@@ -1,3 +1,4 @@
+#include <charconv>
 #include <sstream>
 // #include <limits>
 #include <type_traits>
@@ -86,4 +87,35 @@ private:
 template<typename T>
 std::string Format(const T& t) {
     return TPrettyPrinter().f(t).Str();
-}
\ No newline at end of file
+}
+
+// Дописывает значения прямо в готовый буфер (для ленивого логирования):
+// строки и целые без промежуточных std::string, остальное через TPrettyPrinter
+inline void format_into(std::string& out, const std::string& value) {
+    out += value;
+}
+
+inline void format_into(std::string& out, const char* value) {
+    out += value;
+}
+
+template <IntegerType T>
+void format_into(std::string& out, const T& value) {
+    if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+        out += std::to_string(value);
+    } else {
+        char buf[24];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, res.ptr);
+    }
+}
+
+template <typename T>
+void format_into(std::string& out, const T& value) {
+    out += TPrettyPrinter().f(value).Str();
+}
+
+template <typename... Args>
+void format_all_into(std::string& out, const Args&... args) {
+    (format_into(out, args), ...);
+}
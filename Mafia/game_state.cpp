@@ -0,0 +1,161 @@
+// Подключается и из main.cpp, и из events.cpp
+#ifndef MAFIA_GAME_STATE_CPP
+#define MAFIA_GAME_STATE_CPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Роли и команды как enum: в горячем коде сравниваются байты, а не строки.
+// Строковые имена остаются для конфигов, логов и вывода
+enum class Role : uint8_t { Civilian, Mafia, Maniac, Bull, Commissar, Doctor, Journalist, CommissarFan, Count };
+enum class Team : uint8_t { Civilian, Mafia, Maniac, Draw, Count }; // Draw — только как исход партии
+
+inline constexpr const char *kRoleNames[] = {"civilian", "mafia", "maniac", "bull", "commissar", "doctor", "journalist", "commisarfan"};
+inline constexpr const char *kTeamNames[] = {"civilian", "mafia", "maniac", "draw"};
+
+inline Role role_from_string(std::string_view name)
+{
+    for (size_t i = 0; i < size_t(Role::Count); i++)
+    {
+        if (name == kRoleNames[i])
+            return Role(i);
+    }
+    return Role::Civilian;
+}
+
+inline const char *role_name(Role role) { return kRoleNames[size_t(role)]; }
+inline const char *team_name(Team team) { return kTeamNames[size_t(team)]; }
+
+inline Team team_of(Role role)
+{
+    switch (role)
+    {
+    case Role::Mafia:
+    case Role::Bull:
+        return Team::Mafia;
+    case Role::Maniac:
+        return Team::Maniac;
+    default:
+        return Team::Civilian;
+    }
+}
+
+inline Team team_from_string(std::string_view name)
+{
+    for (size_t i = 0; i < size_t(Team::Count); i++)
+    {
+        if (name == kTeamNames[i])
+            return Team(i);
+    }
+    return Team::Draw;
+}
+
+// Состояние партии массивами по id игрока: роль, команда и битсет живых.
+// Счётчики живых по командам обновляются при каждой смерти, поэтому
+// проверка конца игры — O(1), а перебор живых — проход по словам битсета
+struct GameState
+{
+    std::vector<Role> role;
+    std::vector<Team> team;
+    std::vector<uint64_t> alive_bits;
+    std::array<unsigned int, size_t(Team::Count)> alive_by_team{};
+    unsigned int alive_total = 0;
+
+    void reset(size_t players_num)
+    {
+        role.clear();
+        team.clear();
+        role.reserve(players_num);
+        team.reserve(players_num);
+        alive_bits.assign((players_num + 63) / 64, 0);
+        alive_by_team.fill(0);
+        alive_total = 0;
+    }
+
+    // Игроки добавляются по порядку id, живыми
+    void add(Role r)
+    {
+        size_t id = role.size();
+        role.push_back(r);
+        team.push_back(team_of(r));
+        if (id / 64 >= alive_bits.size())
+            alive_bits.resize(id / 64 + 1, 0);
+        alive_bits[id / 64] |= uint64_t(1) << (id % 64);
+        alive_by_team[size_t(team.back())]++;
+        alive_total++;
+    }
+
+    size_t size() const { return role.size(); }
+
+    bool is_alive(size_t id) const
+    {
+        return (alive_bits[id / 64] >> (id % 64)) & 1;
+    }
+
+    void kill(size_t id)
+    {
+        if (!is_alive(id))
+            return;
+        alive_bits[id / 64] &= ~(uint64_t(1) << (id % 64));
+        alive_by_team[size_t(team[id])]--;
+        alive_total--;
+    }
+
+    unsigned int alive(Team t) const { return alive_by_team[size_t(t)]; }
+
+    // f(id) для каждого живого по возрастанию id
+    template <typename F>
+    void for_each_alive(F &&f) const
+    {
+        for (size_t w = 0; w < alive_bits.size(); w++)
+        {
+            for (uint64_t bits = alive_bits[w]; bits; bits &= bits - 1)
+                f(w * 64 + size_t(std::countr_zero(bits)));
+        }
+    }
+
+    std::vector<size_t> alive_ids() const
+    {
+        std::vector<size_t> ids;
+        alive_ids_into(ids);
+        return ids;
+    }
+
+    // То же в чужой буфер: его ёмкость переиспользуется от хода к ходу
+    void alive_ids_into(std::vector<size_t> &ids) const
+    {
+        ids.clear();
+        ids.reserve(alive_total);
+        for_each_alive([&](size_t id) { ids.push_back(id); });
+    }
+};
+
+// Что игрок видит о партии во время своего хода. Только чтение, передаётся по ссылке:
+// список живых — span на буфер ведущего, роли и команды читаются прямо из GameState.
+// Живёт, пока ведущий не соберёт результаты всех корутин хода
+class GameView
+{
+public:
+    GameView(const GameState &state_, std::span<const size_t> alive_) : state(state_), alive(alive_) {}
+
+    // живые на начало хода, по возрастанию id
+    std::span<const size_t> alive_ids() const { return alive; }
+    size_t players() const { return state.size(); }
+
+    bool is_alive(size_t id) const { return id < state.size() && state.is_alive(id); }
+    // id может прийти прямо из stdin (ход живого игрока): для чужого id — Role::Count / Team::Count,
+    // которые не совпадают ни с одной настоящей ролью или командой
+    Role role(size_t id) const { return id < state.size() ? state.role[id] : Role::Count; }
+    Team team(size_t id) const { return id < state.size() ? state.team[id] : Team::Count; }
+
+private:
+    const GameState &state;
+    std::span<const size_t> alive;
+};
+
+#endif // MAFIA_GAME_STATE_CPP
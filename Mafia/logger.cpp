@@ -1,12 +1,42 @@
+#include <atomic>
 #include <ctime>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <filesystem>
+#include <string>
+#include <thread>
 
 // Enum to represent log levels
 enum class Loglevel { DEBUG, INFO, WARNING, ERROR, CRITICAL };
 
+// Минимальный уровень на этапе компиляции: LOG() ниже него не попадает в бинарник вовсе.
+// Задаётся -DLOG_MIN_LEVEL=<0..4> (0 = DEBUG, всё включено)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+inline constexpr Loglevel kMinLogLevel = static_cast<Loglevel>(LOG_MIN_LEVEL);
+
+// LOG(sink, INFO, "Player ", id, " voted") — sink: Logger или объект с log_enabled/log_with.
+// Аргументы не вычисляются, если уровень отрезан при компиляции или выключен в рантайме,
+// и форматируются (format_all_into) в буфер потока, который затем отдаётся в ячейку очереди
+#define LOG(sink, level, ...)                                                              \
+    do {                                                                                   \
+        if constexpr (Loglevel::level >= kMinLogLevel) {                                   \
+            if ((sink).log_enabled(Loglevel::level))                                       \
+                (sink).log_with(Loglevel::level,                                           \
+                                [&](std::string& log_buf_) { format_all_into(log_buf_, __VA_ARGS__); }); \
+        }                                                                                  \
+    } while (0)
+
+// Асинхронный логгер: log() только кладёт готовую запись в кольцевой буфер без блокировок,
+// фоновый поток забирает записи пачками и пишет их в файл одним write.
+// Файл открыт на всю партию; смена файла (start.log -> day_N.log -> result.log) —
+// это тоже запись в очереди, поэтому выполняется писателем строго по порядку.
+// Гарантия: flush() возвращается, когда всё поставленное до него лежит в файле;
+// деструктор дописывает очередь целиком и закрывает файл.
 class Logger {
 public:
     // Constructor: Opens the log file in append mode
@@ -14,42 +44,229 @@ public:
     {
         logsDir = std::filesystem::current_path() / "logs";
         std::filesystem::create_directory(logsDir);
-        logFile.open(logsDir / filename, std::ios::app);
-        if (!logFile.is_open()) {
-            std::cerr << "Error opening log file." << std::endl;
-        }
+        open(filename);
+        writer = std::thread([this] { writerLoop(); });
     }
 
-    // Destructor: Closes the log file
-    ~Logger() { logFile.close(); }
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Destructor: drains the queue and closes the log file
+    ~Logger()
+    {
+        push(Record::Kind::Stop, Loglevel::INFO, 0, [](std::string&) {});
+        writer.join();
+        logFile.close();
+    }
 
     // Logs a message with a given log level
     void log(Loglevel level, const std::string& message)
     {
-        // Create log entry
-        std::ostringstream logEntry;
-        // logEntry << "[" << timestamp << "] "
-        logEntry << levelToString(level) << ": " << message
-                 << std::endl;
+        if (log_enabled(level))
+            log_with(level, [&](std::string& buf) { buf += message; });
+    }
 
-#ifdef DEBUG_MODE
-        // Output to console
-        std::cout << logEntry.str();
-#endif
+    // Уровень в рантайме; проверяется до форматирования
+    void set_level(Loglevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool log_enabled(Loglevel level) const
+    {
+        return level >= kMinLogLevel && level >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    // fill(std::string&) дописывает сообщение в строку потока, которая затем меняется местами
+    // со строкой ячейки; ёмкости переиспользуются, так что в установившемся режиме аллокаций нет
+    template <typename Fill>
+    void log_with(Loglevel level, Fill&& fill)
+    {
+        push(Record::Kind::Message, level, 0, fill);
+    }
+
+    // Последующие записи пойдут в logs/filename
+    void rotate(const std::string& filename)
+    {
+        push(Record::Kind::Rotate, Loglevel::INFO, 0, [&](std::string& buf) { buf += filename; });
+    }
 
-        // Output to log file
-        if (logFile.is_open()) {
-            logFile << logEntry.str();
-            logFile.flush(); // Ensure immediate write to file
+    // Блокируется, пока всё записанное до вызова не окажется в файле
+    void flush()
+    {
+        // acq_rel: кто взял билет позже, кладёт свою запись Flush после всех наших сообщений,
+        // поэтому его обработка покрывает и наш билет
+        uint64_t ticket = flushRequested.fetch_add(1, std::memory_order_acq_rel) + 1;
+        push(Record::Kind::Flush, Loglevel::INFO, ticket, [](std::string&) {});
+        for (uint64_t done = flushed.load(std::memory_order_acquire); done < ticket;
+             done = flushed.load(std::memory_order_acquire)) {
+            flushed.wait(done, std::memory_order_acquire);
         }
     }
 
 private:
+    struct Record {
+        enum class Kind { Message, Rotate, Flush, Stop };
+        Kind kind;
+        Loglevel level;
+        std::string text; // сообщение или имя файла для Rotate
+        uint64_t ticket;  // номер для Flush
+    };
+
+    // Ограниченная MPMC-очередь Вьюкова: у каждой ячейки свой счётчик поколения,
+    // производители и писатель синхронизируются только через него
+    struct Slot {
+        std::atomic<size_t> seq;
+        Record record;
+    };
+
+    static constexpr size_t kCapacity = 4096;         // степень двойки
+    static constexpr size_t kBatchBytes = 64 * 1024; // размер одной записи в файл
+
     std::filesystem::path logsDir;
     std::ofstream logFile; // File stream for the log file
 
+    std::unique_ptr<Slot[]> ring = makeRing();
+    alignas(64) std::atomic<size_t> head{0};     // следующая позиция записи
+    alignas(64) size_t tail = 0;                 // следующая позиция чтения (только писатель)
+    alignas(64) std::atomic<uint32_t> wakeups{0}; // будильник писателя (futex через atomic::wait)
+    std::atomic<Loglevel> minLevel{Loglevel::DEBUG};
+    std::atomic<uint64_t> flushRequested{0};
+    std::atomic<uint64_t> flushed{0};
+    std::thread writer;
+
+    static std::unique_ptr<Slot[]> makeRing()
+    {
+        auto r = std::make_unique<Slot[]>(kCapacity);
+        for (size_t i = 0; i < kCapacity; ++i)
+            r[i].seq.store(i, std::memory_order_relaxed);
+        return r;
+    }
+
+    void open(const std::string& filename)
+    {
+        logFile.open(logsDir / filename, std::ios::app);
+        if (!logFile.is_open()) {
+            std::cerr << "Error opening log file." << std::endl;
+        }
+    }
+
+    // Производитель: при полной очереди ждёт писателя, записи не теряются.
+    // Форматирование — до захвата ячейки: если fill бросит, ячейка не останется
+    // занятой навсегда (писатель ждал бы её seq вечно)
+    template <typename Fill>
+    void push(Record::Kind kind, Loglevel level, uint64_t ticket, Fill&& fill)
+    {
+        thread_local std::string text;
+        text.clear();
+        fill(text);
+
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = ring[pos & (kCapacity - 1)];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    Record& rec = slot.record;
+                    rec.kind = kind;
+                    rec.level = level;
+                    rec.ticket = ticket;
+                    rec.text.swap(text);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    break;
+                }
+            } else if (diff < 0) {
+                std::this_thread::yield();
+                pos = head.load(std::memory_order_relaxed);
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_one();
+    }
+
+    // Запись обрабатывается на месте, строка остаётся в ячейке для следующего push
+    Record* front()
+    {
+        Slot& slot = ring[tail & (kCapacity - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != tail + 1)
+            return nullptr;
+        return &slot.record;
+    }
+
+    void release()
+    {
+        ring[tail & (kCapacity - 1)].seq.store(tail + kCapacity, std::memory_order_release);
+        ++tail;
+    }
+
+    void writeBatch(std::string& batch)
+    {
+        if (!batch.empty() && logFile.is_open())
+            logFile.write(batch.data(), std::streamsize(batch.size()));
+        batch.clear();
+    }
+
+    void writerLoop()
+    {
+        std::string batch;
+        batch.reserve(kBatchBytes);
+        for (;;) {
+            uint32_t seen = wakeups.load(std::memory_order_acquire);
+            bool got = false;
+            while (Record* cur = front()) {
+                const Record& rec = *cur;
+                got = true;
+                bool stop = false;
+                switch (rec.kind) {
+                    case Record::Kind::Message:
+                        batch += levelToString(rec.level);
+                        batch += ": ";
+                        batch += rec.text;
+                        batch += '\n';
+#ifdef DEBUG_MODE
+                        // Output to console
+                        std::cout << levelToString(rec.level) << ": " << rec.text << std::endl;
+#endif
+                        if (batch.size() >= kBatchBytes)
+                            writeBatch(batch);
+                        break;
+                    case Record::Kind::Rotate:
+                        writeBatch(batch);
+                        logFile.close();
+                        open(rec.text);
+                        break;
+                    case Record::Kind::Flush:
+                        writeBatch(batch);
+                        logFile.flush();
+                        // билеты берутся до push, и Flush в очереди могут идти не по порядку:
+                        // flushed только растёт, иначе ждущий старшего билета снова уснул бы
+                        for (uint64_t done = flushed.load(std::memory_order_relaxed);
+                             done < rec.ticket &&
+                             !flushed.compare_exchange_weak(done, rec.ticket, std::memory_order_release,
+                                                            std::memory_order_relaxed);) {
+                        }
+                        flushed.notify_all();
+                        break;
+                    case Record::Kind::Stop:
+                        writeBatch(batch);
+                        logFile.flush();
+                        stop = true;
+                        break;
+                }
+                release();
+                if (stop)
+                    return;
+            }
+            // очередь пуста: сбрасываем пачку и спим до следующего push
+            if (got) {
+                writeBatch(batch);
+                logFile.flush();
+            }
+            wakeups.wait(seen, std::memory_order_acquire);
+        }
+    }
+
     // Converts log level to a string for output
-    std::string levelToString(Loglevel level)
+    static const char* levelToString(Loglevel level)
     {
         switch (level) {
             case Loglevel::DEBUG:
@@ -66,4 +283,4 @@ private:
                 return "UNKNOWN";
         }
     }
-};
\ No newline at end of file
+};
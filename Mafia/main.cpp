@@ -1,10 +1,13 @@
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <random>
 #include <thread>
 #include <vector>
-#include <map>
+#include <optional>
 #include <coroutine>
 #include <string>
 #include <ranges>
@@ -14,76 +17,36 @@
 #include "formatter.cpp"
 #include "smart_ptr.cpp"
 #include "logger.cpp"
+#include "scheduler.cpp"
+#include "game_state.cpp"
+#include "events.cpp"
 
 
-namespace view = std::ranges::views;
 
-struct Task {
-    struct promise_type {
-        size_t result;
-        
-        Task get_return_object() {
-            return Task{ std::coroutine_handle<promise_type>::from_promise(*this) };
-        }
-        std::suspend_always initial_suspend() noexcept { return {}; }
-        std::suspend_always final_suspend() noexcept { return {}; }
-        void return_value(size_t value) {
-            result = value;
-        }
-        void unhandled_exception() { std::terminate(); }
-    };
-
-    std::coroutine_handle<promise_type> handle;
-
-    Task(std::coroutine_handle<promise_type> h) : handle(h) {}
-    Task(const Task&) = delete;
-    Task& operator=(const Task&) = delete;
-    Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
-    Task& operator=(Task&& other) noexcept {
-        if (this != &other) {
-            if (handle) handle.destroy();
-            handle = other.handle;
-            other.handle = nullptr;
-        }
-        return *this;
-    }
-    ~Task() { if (handle) handle.destroy(); }
-
-    void resume() {
-        if (handle && !handle.done())
-            handle.resume();
-    }
-
-    bool done() const {
-        return !handle || handle.done();
-    }
-    
-    size_t get_result() const {
-        return handle.promise().result;
-    }
-
-    // Добавляем поддержку co_await для Task
-    bool await_ready() const noexcept {
-        return done(); // Если корутина завершена, готовы сразу
-    }
+// Генератор партии: у каждой игры свой, сидируется от базового сида и номера партии.
+// Глобального rand() нет, поэтому партии можно играть параллельно и воспроизводить по одной
+using GameRng = std::mt19937_64;
 
-    void await_suspend(std::coroutine_handle<> awaiting_coro) noexcept {
-        resume();
-    }
-
-    size_t await_resume() const noexcept {
-        return get_result(); // Возвращаем результат когда корутина завершена
-    }
-};
+// Сид i-й партии (splitmix64): не зависит от того, какой поток и в каком порядке её играет
+inline uint64_t game_seed(uint64_t base_seed, uint64_t game_index)
+{
+    uint64_t z = base_seed + (game_index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
 
 // Перемешаем
 template <typename T>
-void simple_shuffle(T &container)
+void simple_shuffle(T &container, GameRng &rng)
 {
-    std::mt19937 g(rand());
-    std::shuffle(container.begin(), container.end(), g);
+    std::shuffle(container.begin(), container.end(), rng);
 }
 
+// Поток-заглушка для безголового режима: без streambuf запись сразу отбрасывается.
+// Своя в каждом потоке, иначе параллельные партии гоняют флаги одного ostream
+inline thread_local std::ostream null_out{nullptr};
+
 struct NightActions
 {
     // флаги действий для парсинга ночных действий
@@ -134,82 +97,95 @@ class Player
 public:
     Player(size_t id_p) : id(id_p)
     {
-        alive = true;           // Игрок жив при создании
         is_real_player = false; // По дефолту - компьютерный игрок
         is_boss = false;        // По дуфолту - не босс мафии
     };
 
     virtual ~Player() {};
 
-    // голосование (возвращает корутину)
-    virtual Task vote(std::vector<size_t> alive_ids)
+    // голосование (возвращает корутину).
+    // view хранится в корутине по ссылке: ведущий держит его, пока не соберёт результаты
+    virtual Task vote(const GameView &view, GameRng &rng)
     {
         if (is_real_player)
         {
             // Для реального игрока просто вызываем его метод
-            co_return co_await vote_player(alive_ids);
+            co_return co_await vote_player(view);
         }
         else
         {
             // Для ИИ вызываем синхронный метод и возвращаем результат
             size_t result;
-            vote_ai(alive_ids, result);
+            vote_ai(view, result, rng);
             co_return result;
         }
     }
 
     // ночное действие -> корутина
-    virtual Task act(std::vector<size_t> alive_ids,
+    virtual Task act(const GameView &view,
                      NightActions &night_actions,
-                     std::vector<SmartPtr<Player>> players)
+                     GameRng &rng)
     {
         if (is_real_player)
         {
             // Для реального игрока просто вызываем его метод
-            co_await act_player(alive_ids, night_actions, players);
+            co_await act_player(view, night_actions);
             co_return 0;
         }
         else
         {
             // Для ИИ вызываем синхронный метод
-            act_ai(alive_ids, night_actions, players);
+            act_ai(view, night_actions, rng);
             co_return 0;
         }
     }
 
-    virtual void vote_ai(std::vector<size_t> &alive_ids, size_t &value) = 0;
+    virtual void vote_ai(const GameView &view, size_t &value, GameRng &rng) = 0;
 
     // Человек голосует
-    virtual Task vote_player(std::vector<size_t> &alive_ids)
+    virtual Task vote_player(const GameView &view)
     {
         std::cout << "Пришло время дневного голосования. За кого вы голосуете?" << std::endl;
 
-        for (auto i : alive_ids)
+        for (auto i : view.alive_ids())
         {
             std::cout << i << " ";
         }
         std::cout << std::endl;
         
         size_t res;
+        co_await stdin_readable();
         std::cin >> res;
         co_return res;
     }
 
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>> players) = 0;
+                        GameRng &rng) = 0;
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>> players) = 0;
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) = 0;
 
-    bool alive;          // жив?
     bool is_real_player; // это человек?
     bool is_boss;        // это босс мафии?
     size_t id;
     std::vector<size_t> known_mafia{}; // список мафий для типов "мафия" и "комиссар", так как они голосуют по особенному
-    std::string team;                  // Команда ("civilian", "mafia", "maniac")
-    std::string role;                  // Роль
+    Team team;                         // Команда
+    Role role;                         // Роль
+    std::ostream *out = &std::cout;    // куда ИИ сообщает о своих действиях (null_out в симуляции)
+
+protected:
+    // Живые в случайном порядке для ИИ: общий список из view не трогаем,
+    // перемешиваем копию в своём буфере (его ёмкость живёт до конца партии)
+    std::span<const size_t> shuffled_alive(const GameView &view, GameRng &rng)
+    {
+        order.assign(view.alive_ids().begin(), view.alive_ids().end());
+        simple_shuffle(order, rng);
+        return order;
+    }
+
+private:
+    std::vector<size_t> order;
 };
 
 class Civilian : public Player
@@ -217,14 +193,14 @@ class Civilian : public Player
 public:
     Civilian(size_t id_p) : Player(id_p)
     {
-        team = "civilian";
-        role = "civilian";
+        team = Team::Civilian;
+        role = Role::Civilian;
     }
     virtual ~Civilian() {};
 
-    virtual void vote_ai(std::vector<size_t> &alive_ids, size_t &value) override
+    virtual void vote_ai(const GameView &view, size_t &value, GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         size_t i = 0;
         while (i < alive_ids.size())
         {
@@ -240,12 +216,12 @@ public:
     }
 
     // Мирный ночью спит
-    virtual void act_ai(std::vector<size_t> &, NightActions &, std::vector<SmartPtr<Player>>) override
+    virtual void act_ai(const GameView &, NightActions &, GameRng &) override
     {
         return;
     }
 
-    virtual Task act_player(std::vector<size_t> &, NightActions &, std::vector<SmartPtr<Player>>) override
+    virtual Task act_player(const GameView &, NightActions &) override
     {
         std::cout << "Вы мирный житель. Ночью вы спите." << std::endl;
         co_return 0;
@@ -261,37 +237,35 @@ public:
     {
         already_checked = {id}; // Начинаем с проверки себя
         known_civilian = {id};  // Себя знаем как мирного
-        role = "commissar";
+        role = Role::Commissar;
     }
     virtual ~Commissar() {};
 
-    virtual void vote_ai(std::vector<size_t> &alive_ids, size_t &value) override
+    virtual void vote_ai(const GameView &view, size_t &value, GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
-
         // Сначала голосуем против известных мафиози, если они живы
         for (size_t i = 0; i < known_mafia.size(); i++)
         {
-            if (std::find(alive_ids.begin(), alive_ids.end(), known_mafia[i]) != alive_ids.end())
+            if (view.is_alive(known_mafia[i]))
             {
                 value = known_mafia[i]; // Голосуем против мафиози
                 return;
             }
         }
         // Если известных мафиози нет, голосуем как обычный житель
-        Civilian::vote_ai(alive_ids, value);
+        Civilian::vote_ai(view, value, rng);
         return;
     }
 
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>> players) override
+                        GameRng &) override
     {
 
         // Если есть известные мафиози среди живых - стреляем в них
         for (size_t i = 0; i < known_mafia.size(); i++)
         {
-            if (std::find(alive_ids.begin(), alive_ids.end(), known_mafia[i]) != alive_ids.end())
+            if (view.is_alive(known_mafia[i]))
             {
                 night_actions.killers[known_mafia[i]].push_back(id); // читаетс как в игрока (i) [он же мафия] стрелял игрок id [он же комиссарр]
                 return;
@@ -300,7 +274,7 @@ public:
 
         // Иначе проверяем нового игрока
 
-        for (const auto &i : alive_ids)
+        for (const auto &i : view.alive_ids())
         {
 
             // Ищем еще не проверенного игрока
@@ -309,7 +283,7 @@ public:
                 already_checked.push_back(i); // Добавляем в проверенные
 
                 // Запоминаем результат
-                if (players[i]->team == "mafia")
+                if (view.team(i) == Team::Mafia)
                 {
                     known_mafia.push_back(i);
                 }
@@ -326,23 +300,29 @@ public:
         return;
     }
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>> players) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         while (true)
         {
             std::cout << "Вы коммисар! Выберите действие: ВЫСТРЕЛИТЬ (s) или ПРОВЕРИТЬ (c)." << std::endl;
             std::string choice;
+            co_await stdin_readable();
             std::cin >> choice;
             std::cout << "Выберите цель:" << std::endl;
-            for (auto i : alive_ids)
+            for (auto i : view.alive_ids())
             {
                 std::cout << i << " ";
             }
             std::cout << std::endl;
             size_t shoot_check;
+            co_await stdin_readable();
             std::cin >> shoot_check;
+            if (shoot_check >= view.players())
+            {
+                std::cout << "Неверный ID игрока! Доступные ID: 0-" << view.players() - 1 << std::endl;
+                continue;
+            }
 
             if (choice == "shoot" || choice == "s")
             {
@@ -352,7 +332,7 @@ public:
             else if (choice == "check" || choice == "c")
             {
                 std::cout << "Игрок " << shoot_check
-                          << ((players[shoot_check]->team == "mafia") ? "мафия" : "не мафия") << std::endl;
+                          << ((view.team(shoot_check) == Team::Mafia) ? "мафия" : "не мафия") << std::endl;
                 night_actions.commissar_action = true;
                 night_actions.commissar_choice = shoot_check;
                 co_return 0;
@@ -371,16 +351,16 @@ class Doctor : public Civilian
 public:
     Doctor(size_t id_p) : Civilian(id_p)
     {
-        role = "doctor";
+        role = Role::Doctor;
         last_heal = std::numeric_limits<size_t>::max(); // сразу ставим максимально возможное значение
     }
     virtual ~Doctor() {}
 
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>>) override
+                        GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         // Ищем игрока, которого не лечили в прошлую ночь и его же лечимы
         for (size_t i = 0; i < alive_ids.size(); i++)
         {
@@ -394,13 +374,12 @@ public:
         }
     }
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>>) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         std::cout << "Вы доктор! Ваша задача спасать игроков от смерти." << std::endl
                   << "Выберите кого хотите вылечить:" << std::endl;
-        for (auto i : alive_ids)
+        for (auto i : view.alive_ids())
         {
             std::cout << i << " ";
         }
@@ -409,6 +388,7 @@ public:
         while (true)
         {
             size_t choice;
+            co_await stdin_readable();
             std::cin >> choice;
             if (last_heal == choice)
             {
@@ -431,16 +411,16 @@ class Journalist : public Civilian
 public:
     Journalist(size_t id_p) : Civilian(id_p)
     {
-        role = "journalist";
+        role = Role::Journalist;
     }
     virtual ~Journalist() {}
 
     // проверяет двух случайных игроков
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>>) override
+                        GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         // Перебираем все пары ЖИВЫХ игроков (кроме себя)
         for (const auto &i : alive_ids)
         {
@@ -455,12 +435,11 @@ public:
         }
     }
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>> players) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         std::cout << "Вы журналист! Выберите двух игроков для сранения их ролей:" << std::endl;
-        for (auto i : alive_ids)
+        for (auto i : view.alive_ids())
         {
             std::cout << i << " ";
         }
@@ -470,15 +449,16 @@ public:
         while (true)
         {
             size_t first, second;
+            co_await stdin_readable();
             std::cin >> first >> second;
-            if (first >= players.size() || second >= players.size()) {
-                std::cout << "Неверные ID игроков! Доступные ID: 0-" << players.size()-1 << std::endl;
+            if (first >= view.players() || second >= view.players()) {
+                std::cout << "Неверные ID игроков! Доступные ID: 0-" << view.players()-1 << std::endl;
                 continue;
             }
             if (first != id && second != id)
             {
                 // Проверяем, одной ли команды игроки
-                if (players[first]->team == players[second]->team)
+                if (view.team(first) == view.team(second))
                 {
                     std::cout << "Они на одной стороне)" << std::endl;
                 }
@@ -505,15 +485,15 @@ class Mafia : public Player
 public:
     Mafia(size_t id_p) : Player(id_p)
     {
-        team = "mafia";
-        role = "mafia";
+        team = Team::Mafia;
+        role = Role::Mafia;
     }
     virtual ~Mafia() {}
 
     // голосует против НЕ мафов
-    virtual void vote_ai(std::vector<size_t> &alive_ids, size_t &value) override
+    virtual void vote_ai(const GameView &view, size_t &value, GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         size_t i = 0;
         // Ищем первого игрока, который не мафия
         while (i < alive_ids.size())
@@ -531,20 +511,20 @@ public:
     }
 
     // только босс мафии выбирает жертву
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>>) override
+                        GameRng &rng) override
     {
         if (is_boss)
         { // Только босс мафии совершает убийство
-            simple_shuffle(alive_ids);
+            auto alive_ids = shuffled_alive(view, rng);
             size_t i = 0;
             // Ищем не-мафиози для убийства
             while (i < alive_ids.size())
             {
                 if (std::find(known_mafia.begin(), known_mafia.end(), alive_ids[i]) == known_mafia.end())
                 {
-                    std::cout << "Мафия выбрала свою цель!" << std::endl;
+                    *out << "Мафия выбрала свою цель!" << std::endl;
                     night_actions.killers[alive_ids[i]].push_back(id);
                     return;
                 }
@@ -553,9 +533,8 @@ public:
         }
     }
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>>) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         std::cout << "Клан мафии состоит из:" << std::endl;
         for (auto i : known_mafia)
@@ -568,12 +547,13 @@ public:
         {
             std::cout << "Вы Босс мафии. Вы решаете кого убить этой ночью" << std::endl
                       << "Выберите одного игрока из списка:" << std::endl;
-            for (auto i : alive_ids)
+            for (auto i : view.alive_ids())
             {
                 std::cout << i << " ";
             }
             std::cout << std::endl;
             size_t choice;
+            co_await stdin_readable();
             std::cin >> choice;
             night_actions.killers[choice].push_back(id);
         }
@@ -592,34 +572,34 @@ class CommissarFan : public Civilian
 public:
     CommissarFan(size_t id_p) : Civilian(id_p)
     {
-        role = "commisarfan";
+        role = Role::CommissarFan;
         found_commissar = false;
         checked.push_back(id); // не проверяет саму себя
     }
 
     virtual ~CommissarFan() {}
 
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>> players) override
+                        GameRng &rng) override
     {
         if (found_commissar)
             return; // если уже нашла комиссара — больше не действует
 
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         for (const auto &i : alive_ids)
         {
             if (std::find(checked.begin(), checked.end(), i) == checked.end() && i != id)
             {
                 checked.push_back(i);
-                if (players[i]->role == "commissar")
+                if (view.role(i) == Role::Commissar)
                 {
-                    std::cout << "Поклонница комиссара нашла своего кумира!" << std::endl;
+                    *out << "Поклонница комиссара нашла своего кумира!" << std::endl;
                     found_commissar = true;
                 }
                 else
                 {
-                    std::cout << "Поклонница комиссара проверила игрока " << i
+                    *out << "Поклонница комиссара проверила игрока " << i
                               << " — не комиссар." << std::endl;
                 }
                 night_actions.commisarfan_action = true;
@@ -631,9 +611,8 @@ public:
 
     }
 
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>> players) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         if (found_commissar)
         {
@@ -642,13 +621,14 @@ public:
         }
 
         std::cout << "Вы — поклонница комиссара! Выберите игрока, чтобы проверить, не он ли комиссар:" << std::endl;
-        for (const auto &i : alive_ids)
+        for (const auto &i : view.alive_ids())
         {
             std::cout << i << " ";
         }
         std::cout << std::endl;
 
         size_t choice;
+        co_await stdin_readable();
         std::cin >> choice;
 
         if (choice == id)
@@ -658,7 +638,7 @@ public:
         }
 
         checked.push_back(choice);
-        if (players[choice]->role == "commissar")
+        if (view.role(choice) == Role::Commissar)
         {
             std::cout << "Игрок " << choice << " — комиссар! Вы успокоились и больше не будете проверять ночью." << std::endl;
             found_commissar = true;
@@ -679,7 +659,7 @@ class Bull : public Mafia
 public:
     Bull(size_t id_p) : Mafia(id_p)
     {
-        role = "bull"; // Специальная роль в мафии
+        role = Role::Bull; // Специальная роль в мафии
     }
     virtual ~Bull() {}
 };
@@ -689,15 +669,15 @@ class Maniac : public Player
 public:
     Maniac(size_t id_p) : Player(id_p)
     {
-        team = "maniac";
-        role = "maniac";
+        team = Team::Maniac;
+        role = Role::Maniac;
     }
     virtual ~Maniac() {};
 
     // голосует против любого другого игрока
-    virtual void vote_ai(std::vector<size_t> &alive_ids, size_t &value) override
+    virtual void vote_ai(const GameView &view, size_t &value, GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         size_t i = 0;
         while (i < alive_ids.size())
         {
@@ -713,17 +693,17 @@ public:
     }
 
     // убивает случайного игрока
-    virtual void act_ai(std::vector<size_t> &alive_ids,
+    virtual void act_ai(const GameView &view,
                         NightActions &night_actions,
-                        std::vector<SmartPtr<Player>> players) override
+                        GameRng &rng) override
     {
-        simple_shuffle(alive_ids);
+        auto alive_ids = shuffled_alive(view, rng);
         size_t i = 0;
         while (i < alive_ids.size())
         {
-            if (alive_ids[i] != id && players[alive_ids[i]] -> role != "bull")
+            if (alive_ids[i] != id && view.role(alive_ids[i]) != Role::Bull)
             { // Не может убить себя и быка
-                std::cout << "Маньяк выбрал свою цель!" << std::endl;
+                *out << "Маньяк выбрал свою цель!" << std::endl;
                 night_actions.killers[alive_ids[i]].push_back(id);
                 return;
             }
@@ -732,18 +712,18 @@ public:
     }
 
     // версия для реального игрока-маньяка
-    virtual Task act_player(std::vector<size_t> &alive_ids,
-                            NightActions &night_actions,
-                            std::vector<SmartPtr<Player>> players) override
+    virtual Task act_player(const GameView &view,
+                            NightActions &night_actions) override
     {
         std::cout << "Ты маньяк, кого ты выберешь своей жертвой этой ночью?" << std::endl;
-        for (auto i : alive_ids)
+        for (auto i : view.alive_ids())
         {
-            if (players[i] -> role != "bull")
+            if (view.role(i) != Role::Bull)
                 std::cout << i << " ";
         }
         std::cout << std::endl;
         size_t choice;
+        co_await stdin_readable();
         std::cin >> choice;
         night_actions.killers[choice].push_back(id);
         co_return 0;
@@ -752,16 +732,16 @@ public:
 
 template <typename T>
 concept PlayerConcept = requires(T player,
-                                 std::vector<size_t> ids,
+                                 const GameView &view,
                                  size_t value,
                                  NightActions night_actions,
-                                 std::vector<SmartPtr<Player>> players) {
+                                 GameRng rng) {
     // Проверяю, что у ведущего классы, для которых определены методы vote и act в объектах
 
     // тип T имеет  vote
-    { player.vote(ids) } -> std::same_as<Task>;
+    { player.vote(view, rng) } -> std::same_as<Task>;
     // тип T имеет  act
-    { player.act(ids, night_actions, players) } -> std::same_as<Task>;
+    { player.act(view, night_actions, rng) } -> std::same_as<Task>;
 };
 
 // Считывание ролей из конфигурационного файла
@@ -815,10 +795,25 @@ template <PlayerConcept Player>
 class Game
 {
 public:
-    Logger *logger;
-    std::vector<SmartPtr<Player>> players{}; // массив игроков
+    // Память партии: игроки с их счётчиками и кадры корутин ходов. Объявлена первой,
+    // чтобы пережить всё, что из неё выделено, и освободиться одним махом в конце партии
+    Arena arena;
+    std::unique_ptr<Logger> logger;          // один на партию, файлы меняет ротацией
+    std::ostream *out = &std::cout;          // консоль ведущего (null_out в симуляции)
+    bool headless = false;                   // без консоли, без логов, без живого игрока
+    unsigned int days_played = 0;            // длина последней партии в днях
+    EventRecorder *recorder = nullptr;       // бинарный журнал событий партии (если задан)
+    std::vector<SmartPtr<Player>> players{}; // массив игроков (поведение)
+    GameState state;                         // роли, команды и живые массивами (для проверок и фильтров)
     unsigned int players_num;                      // количество игроков
     unsigned int mafia_modifier;                   // Модификатор для расчета количества мафии
+    GameRng rng;                                   // генератор партии: роли и решения ИИ
+    // Буферы хода: переиспользуются каждый день и каждую ночь, чтобы ход не аллоцировал
+    std::vector<size_t> alive_buf;                  // живые на начало хода (GameView смотрит сюда)
+    std::vector<std::pair<Player *, Task>> turn_tasks; // корутины хода; игроками владеет players
+    std::vector<unsigned int> vote_buf;             // голоса дня по id
+    std::vector<size_t> mafia_buf;                  // живые мафиози при перевыборах босса
+    NightActions night_actions;
 
     // Доступные роли
     std::vector<std::string> civilian_roles{"commissar", "doctor", "journalist", "commisarfan"};
@@ -827,9 +822,53 @@ public:
     // size_t commisarfan_id = std::numeric_limits<size_t>::max();
     size_t bull_id = std::numeric_limits<size_t>::max();
 
-    explicit Game(unsigned int players_num_, unsigned int mafia_modifier_ = 3) : players_num(players_num_),
-                                                                                 mafia_modifier(mafia_modifier_)
+    explicit Game(unsigned int players_num_, unsigned int mafia_modifier_ = 3, uint64_t seed = 5) : players_num(players_num_),
+                                                                                                    mafia_modifier(mafia_modifier_),
+                                                                                                    rng(seed),
+                                                                                                    night_actions(players_num_)
+    {
+    }
+
+    void set_headless(bool value)
     {
+        headless = value;
+        out = headless ? &null_out : &std::cout;
+    }
+
+    // Первый вызов запускает логгер, последующие переключают файл (ротацию выполняет писатель).
+    // В безголовом режиме логгер не создаётся
+    void open_log(const std::string &filename)
+    {
+        if (headless)
+            return;
+        if (logger)
+            logger->rotate(filename);
+        else
+            logger = std::make_unique<Logger>(filename);
+    }
+
+    // Конец партии: логгер дописывает очередь и закрывает файл
+    void close_log()
+    {
+        logger.reset();
+    }
+
+    void record(EventType type, size_t actor = kNobody, size_t target = kNobody, unsigned int arg = 0)
+    {
+        if (recorder)
+            recorder->add(type, actor, target, arg);
+    }
+
+    // Приёмник для LOG(*this, ...): без логгера (безголовый режим) сообщения даже не форматируются
+    bool log_enabled(Loglevel level) const
+    {
+        return logger && logger->log_enabled(level);
+    }
+
+    template <typename Fill>
+    void log_with(Loglevel level, Fill &&fill)
+    {
+        logger->log_with(level, std::forward<Fill>(fill));
     }
 
     // добавлениt случайных ролей
@@ -839,9 +878,8 @@ public:
         std::string default_role,
         std::vector<std::string> &result)
     {
-        std::mt19937 g(rand());
         size_t i = 0;
-        std::shuffle(roles.begin(), roles.end(), g);
+        simple_shuffle(roles, rng);
         while (i < limit)
         {
             if (i < roles.size())
@@ -866,8 +904,7 @@ public:
         random_roles.push_back("maniac");
         add_random_roles(civilian_roles, players_num - mafia_num - 1, "civilian", random_roles);
 
-        std::mt19937 g(rand());
-        std::shuffle(random_roles.begin(), random_roles.end(), g);
+        simple_shuffle(random_roles, rng);
         return random_roles;
     }
 
@@ -875,21 +912,29 @@ public:
     void init_players(std::vector<std::string> roles)
     {
         players.clear();
-        logger = new Logger{"start.log"};
-        logger->log(Loglevel::INFO, "===================================== Игра началась!!! =====================================");
+        open_log("start.log");
+        LOG(*this, INFO, "===================================== Игра началась!!! =====================================");
 
-        std::cout << "=====================================" << " Доступные роли " << "=====================================" << std::endl;
-        for (size_t i = 0; i < roles.size(); i++)
+        for (size_t slot = 0; slot < roles.size(); slot++)
         {
-            std::cout << i << ": " << roles[i] << std::endl;
+            record(EventType::Setup, slot, kNobody, unsigned(role_from_string(roles[slot])));
         }
 
-        // Запрос у пользователя, хочет ли он играть
-        std::cout << "Если хочешь сыграть в игру выбери роль (от 0 до " << roles.size() - 1
-                  << ") или -1, если хочешь просто понаблюдать." << std::endl;
+        int choice = -1;
+        if (!headless)
+        {
+            std::cout << "=====================================" << " Доступные роли " << "=====================================" << std::endl;
+            for (size_t i = 0; i < roles.size(); i++)
+            {
+                std::cout << i << ": " << roles[i] << std::endl;
+            }
 
-        int choice;
-        std::cin >> choice;
+            // Запрос у пользователя, хочет ли он играть
+            std::cout << "Если хочешь сыграть в игру выбери роль (от 0 до " << roles.size() - 1
+                      << ") или -1, если хочешь просто понаблюдать." << std::endl;
+
+            std::cin >> choice;
+        }
         std::string human_role = "";
 
         if (choice != -1)
@@ -898,7 +943,7 @@ public:
             human_role = roles[choice];
 
             // Это нужно, чтобы когда реальный игрок играл за кого-то он не знал, кто есть кто
-            simple_shuffle(roles);
+            simple_shuffle(roles, rng);
         }
 
         std::vector<size_t> mafia_buf{}; //  буфер для ID мафиози
@@ -909,70 +954,58 @@ public:
         //     std::cout << role;
         // }
         // Создание по распределениею
-        for (const auto &role : roles)
+        state.reset(roles.size());
+        for (const auto &role_str : roles)
         {
-            //std::cout << "TEEEEST" << std::endl;
-            //auto role = roles[i];
-            if (role == "civilian")
+            Role role = role_from_string(role_str);
+            LOG(*this, INFO, "Player ", i, " is ", role_name(role));
+            switch (role)
             {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is civilian").Str());
-                players.push_back(SmartPtr<Player>(new Civilian{i}));
-            }
-            else if (role == "mafia")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is mafia").Str());
+            case Role::Civilian:
+                players.push_back(allocate_smart<Civilian>(arena, i));
+                break;
+            case Role::Mafia:
                 mafia_buf.push_back(i);
-                players.push_back(SmartPtr<Player>(new Mafia{i}));
-            }
-            else if (role == "maniac")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is maniac").Str());
-                players.push_back(SmartPtr<Player>(new Maniac{i}));
-            }
-            else if (role == "bull")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is bull").Str());
-                players.push_back(SmartPtr<Player>(new Bull{i}));
+                players.push_back(allocate_smart<Mafia>(arena, i));
+                break;
+            case Role::Maniac:
+                players.push_back(allocate_smart<Maniac>(arena, i));
+                break;
+            case Role::Bull:
+                players.push_back(allocate_smart<Bull>(arena, i));
                 mafia_buf.push_back(i);
                 bull_id = i;
+                break;
+            case Role::Commissar:
+                players.push_back(allocate_smart<Commissar>(arena, i));
+                break;
+            case Role::Doctor:
+                players.push_back(allocate_smart<Doctor>(arena, i));
+                break;
+            case Role::Journalist:
+                players.push_back(allocate_smart<Journalist>(arena, i));
+                break;
+            case Role::CommissarFan:
+                players.push_back(allocate_smart<CommissarFan>(arena, i));
+                break;
+            default:
+                break;
             }
-            else if (role == "commissar")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is commissar").Str());
-                players.push_back(SmartPtr<Player>(new Commissar{i}));
-            }
-            else if (role == "doctor")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is doctor").Str());
-                players.push_back(SmartPtr<Player>(new Doctor{i}));
-            }
-            else if (role == "journalist")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is journalist").Str());
-                players.push_back(SmartPtr<Player>(new Journalist{i}));
-            }
-            else if (role == "commisarfan")
-            {
-                logger->log(Loglevel::INFO,
-                            TPrettyPrinter().f("Player ").f(i).f(" is commisarfan").Str());
-                players.push_back(SmartPtr<Player>(new CommissarFan{i}));
-                // commisarfan_id = i;
-            }
+            state.add(role);
 
            ++i;
         }
 
+        for (const auto &pl : players)
+        {
+            pl->out = out;
+            record(EventType::RoleAssigned, pl->id, kNobody, unsigned(pl->role));
+        }
+
         // В какую-то мафию или какого-то мирного или другую роль помечаем живым игроком
         for (const auto &pl : players)
         {
-            if (human_role == pl->role)
+            if (choice != -1 && role_from_string(human_role) == pl->role)
             {
                 pl->is_real_player = true;
                 std::cout << "Запомните свой ID, он может понадобиться. ID = " << std::to_string(pl->id) << std::endl;
@@ -988,102 +1021,67 @@ public:
         }
 
         // босс случаен
-        simple_shuffle(mafia_buf);
-        players[mafia_buf[0]]->is_boss = true;
-        delete logger;
+        if (!mafia_buf.empty())
+        {
+            simple_shuffle(mafia_buf, rng);
+            players[mafia_buf[0]]->is_boss = true;
+            record(EventType::BossElected, mafia_buf[0]);
+        }
     }
 
     // если босс убит -- перевыбор
     void reelection_mafia_boss()
     {
-        // ranes для фильтрации живых
-        auto mafia = players |
-                     view::filter([](auto p)
-                                  { return p->alive; }) |
-                     view::filter([](auto p)
-                                  { return p->team == "mafia"; });
-
-        // Если есть живые мафиози, но нет босса - выбираем нового
-        if (!mafia.empty() &&
-            (mafia | view::filter([](auto p)
-                                  { return p->is_boss; }))
-                .empty())
-        {
-            std::vector<SmartPtr<Player>> mafia_vec{mafia.begin(), mafia.end()};
-            simple_shuffle(mafia_vec);
-            mafia_vec[0]->is_boss = true;
-        }
+        if (state.alive(Team::Mafia) == 0)
+            return;
+
+        // Живой босс есть почти всегда: сначала просто ищем его, ничего не собирая
+        bool has_boss = false;
+        state.for_each_alive([&](size_t id)
+                             { has_boss = has_boss || (state.team[id] == Team::Mafia && players[id]->is_boss); });
+        if (has_boss)
+            return;
+
+        auto &mafia_ids = mafia_buf;
+        mafia_ids.clear();
+        state.for_each_alive([&](size_t id)
+                             {
+            if (state.team[id] == Team::Mafia)
+                mafia_ids.push_back(id); });
+        simple_shuffle(mafia_ids, rng);
+        players[mafia_ids[0]]->is_boss = true;
+        record(EventType::BossElected, mafia_ids[0]);
     }
 
     // текущий статус игры
+    // O(1): только счётчики живых по командам из state
     std::string game_status()
     {
-        auto alives = players | view::filter([](auto p)
-                                             { return p->alive; }); // живые к данному моменту
+        unsigned int alives_num = state.alive_total;
+        unsigned int mafia_num = state.alive(Team::Mafia);
+        unsigned int maniac_num = state.alive(Team::Maniac);
 
-        if (alives.empty())
+        if (alives_num == 0)
         {
             // ничья
             return "draw";
         }
-        else
+        if (mafia_num == 0)
         {
-            // Фильтруем живых мафиози
-            auto mafia = alives | view::filter([](auto p)
-                                               { return p->team == "mafia"; });
-
-            if (mafia.empty())
-            {
-                // Мафия мертва
-                auto maniac_alive = alives | view::filter([](auto p)
-                                                          { return p->team == "maniac"; });
-                if (maniac_alive.empty())
-                {
-                    // Маньяк тоже мертв, значит, мирные победили
-                    return "civilian";
-                }
-                else
-                {
-                    // Маньяк жив. Проверим, победил ли он??
-                    if (std::ranges::distance(alives) >= 3)
-                    {
-                        return "continue"; // Игра продолжается
-                    }
-                    else
-                    {
-                        return "maniac"; // Победа маньяка
-                    }
-                }
-            }
-            else
-            {
-                // Мафия жива
-                auto maniac_alive = alives | view::filter([](auto p)
-                                                          { return p->team == "maniac"; });
-                if (maniac_alive.empty())
-                {
-                    // Маньяк мертв - проверяем условия победы мафии
-                    auto alives_num = std::ranges::distance(alives);
-                    auto mafia_num = std::ranges::distance(mafia);
-                    if (alives_num <= mafia_num * 2)
-                    {
-                        return "mafia"; // Победа мафии
-                    }
-                    else
-                    {
-                        return "continue"; // Игра продолжается
-                    }
-                }
-                else
-                {
-                    // Маньяк жив, значит, ещё не победа мафии
-                    return "continue";
-                }
-            }
-        }
+            // Мафия мертва: если и маньяк мертв, мирные победили
+            if (maniac_num == 0)
+                return "civilian";
+            // Маньяк жив. Проверим, победил ли он??
+            return alives_num >= 3 ? "continue" : "maniac";
+        }
+        // Мафия жива; пока жив маньяк, победы мафии нет
+        if (maniac_num == 0 && alives_num <= mafia_num * 2)
+            return "mafia"; // Победа мафии
+        return "continue";
     }
 
-    void main_loop()
+    // Возвращает итог: "mafia", "civilian", "maniac" или "draw"
+    std::string main_loop()
     {
         unsigned int day_number = 0;
         std::string cur_status = "";
@@ -1091,22 +1089,19 @@ public:
         while (true)
         {
 
-            logger = new Logger{"day_" + std::to_string(day_number) + ".log"};
-            logger->log(Loglevel::INFO, "==== DAY " + std::to_string(day_number) + " ====");
-            std::cout << std::endl;
-            std::cout << "===================================== ДЕНЬ" << std::to_string(day_number) << " =====================================" << std::endl;
+            open_log("day_" + std::to_string(day_number) + ".log");
+            LOG(*this, INFO, "==== DAY ", day_number, " ====");
+            if (recorder)
+                recorder->start_day(day_number);
+            *out << std::endl;
+            *out << "===================================== ДЕНЬ" << std::to_string(day_number) << " =====================================" << std::endl;
 
-            std::cout << "Эти игроки до сих пор живы: ";
-            for (const auto &pl : players)
-            {
-                if (pl->alive)
-                {
-                    std::cout << pl->id << " ";
-                }
-            }
-            std::cout << std::endl;
+            *out << "Эти игроки до сих пор живы: ";
+            state.for_each_alive([&](size_t id)
+                                 { *out << id << " "; });
+            *out << std::endl;
 
-            std::cout << "===================================== !ГОЛОСОВАНИЕ! =====================================" << std::endl;
+            *out << "===================================== !ГОЛОСОВАНИЕ! =====================================" << std::endl;
 
             // голосуем
             day_vote();
@@ -1116,189 +1111,140 @@ public:
             cur_status = game_status();
             if (cur_status != "continue")
             {
-                delete logger;
                 break;
             }
 
             // ночь
-            std::cout << std::endl;
-            std::cout << "===================================== НОЧЬ" << std::to_string(day_number) << " =====================================" << std::endl;
+            *out << std::endl;
+            *out << "===================================== НОЧЬ" << std::to_string(day_number) << " =====================================" << std::endl;
 
             night_act();
             reelection_mafia_boss();
             cur_status = game_status();
             if (cur_status != "continue")
             {
-                delete logger;
                 break;
             }
 
             day_number++;
-            delete logger;
         }
+        days_played = day_number + 1;
+        record(EventType::GameEnd, kNobody, kNobody, unsigned(team_from_string(cur_status)));
 
         // Итоговый ресультат
-        logger = new Logger{"result.log"};
+        open_log("result.log");
         if (cur_status == "draw")
         {
-            logger->log(Loglevel::INFO, "This city is terrible, I highly recommend not living here. It's simply unbelievable, they shot each other in just a couple of nights, a city of corpses.");
-            logger->log(Loglevel::INFO, "DRAW!");
-            logger->log(Loglevel::INFO, "Alives: they are all dead...");
+            LOG(*this, INFO, "This city is terrible, I highly recommend not living here. It's simply unbelievable, they shot each other in just a couple of nights, a city of corpses.");
+            LOG(*this, INFO, "DRAW!");
+            LOG(*this, INFO, "Alives: they are all dead...");
         }
         else if (cur_status == "mafia")
         {
-            logger->log(Loglevel::INFO, "This city is mired in crime, the mafia has gained the upper hand and now controls the city.");
-            logger->log(Loglevel::INFO, "MAFIA WIN");
-            std::cout << "===================================== Мафия победила =====================================" << std::endl;
+            LOG(*this, INFO, "This city is mired in crime, the mafia has gained the upper hand and now controls the city.");
+            LOG(*this, INFO, "MAFIA WIN");
+            *out << "===================================== Мафия победила =====================================" << std::endl;
         }
         else if (cur_status == "maniac")
         {
-            logger->log(Loglevel::INFO, "He escaped from the mental hospital and systematically and gradually killed every inhabitant of the city. Neither the mafia nor the sheriff could stop him. He is a maniac.");
-            logger->log(Loglevel::INFO, "MANIAC WINS");
-            std::cout << "===================================== Маньяк победил =====================================" << std::endl;
+            LOG(*this, INFO, "He escaped from the mental hospital and systematically and gradually killed every inhabitant of the city. Neither the mafia nor the sheriff could stop him. He is a maniac.");
+            LOG(*this, INFO, "MANIAC WINS");
+            *out << "===================================== Маньяк победил =====================================" << std::endl;
         }
         else if (cur_status == "civilian")
         {
-            logger->log(Loglevel::INFO, "This city is absolutely safe to live in. Peaceful residents organized a successful democratic election, rooted out a mafia clan, and identified a serial killer.");
-            logger->log(Loglevel::INFO, "CIVILIANS WIN");
-            std::cout << "===================================== Мирные жители победили =====================================" << std::endl;
+            LOG(*this, INFO, "This city is absolutely safe to live in. Peaceful residents organized a successful democratic election, rooted out a mafia clan, and identified a serial killer.");
+            LOG(*this, INFO, "CIVILIANS WIN");
+            *out << "===================================== Мирные жители победили =====================================" << std::endl;
         }
 
         // Записываем выживших игроков
-        logger->log(Loglevel::INFO, "Alives:");
-        for (const auto &player : players)
-        {
-            if (player->alive)
-            {
-                logger->log(Loglevel::INFO, TPrettyPrinter().f("Player ").f(player->id).f(" - ").f(player->role).Str());
-            }
-        }
-        delete logger;
+        LOG(*this, INFO, "Alives:");
+        state.for_each_alive([&](size_t id)
+                             { LOG(*this, INFO, "Player ", id, " - ", role_name(state.role[id])); });
+        close_log();
+        return cur_status;
     }
 
     void day_vote()
     {
-        auto alives = players | view::filter([](auto p) { return p->alive; });
-        auto alives_ids_rng = alives | view::transform([](auto p) { return p->id; });
-        std::vector<size_t> alives_ids{alives_ids_rng.begin(), alives_ids_rng.end()};
+        FrameArenaScope frames{arena};
+        state.alive_ids_into(alive_buf);
+        const GameView view{state, alive_buf};
 
-        std::map<size_t, unsigned int> votes{};
-        for (auto id : alives_ids)
-        {
-            votes[id] = 0;
-        }
+        auto &votes = vote_buf;
+        votes.assign(players_num, 0);
 
-        // Вектор для хранения задач голосования
-        std::vector<std::pair<SmartPtr<Player>, Task>> voting_tasks;
-        
         // Запускаем все корутины голосования
-        for (const auto &player : players)
+        auto &voting_tasks = turn_tasks;
+        for (auto id : alive_buf)
         {
-            if (player->alive)
-            {
-                auto task = player->vote(alives_ids);
-                voting_tasks.emplace_back(player, std::move(task));
-            }
+            voting_tasks.emplace_back(players[id].get(), players[id]->vote(view, rng));
         }
 
-        // Обрабатываем корутины пока все не завершатся
-        bool all_done = false;
-        bool real_player_message_shown = false; // Флаг для отслеживания показа сообщения
-        
-        while (!all_done)
+        // ИИ отрабатывают за один проход очереди, живой игрок ждёт stdin в epoll
+        Scheduler scheduler;
+        for (auto& [player, task] : voting_tasks)
         {
-            all_done = true;
-            
-            for (auto& [player, task] : voting_tasks)
-            {
-                if (!task.done())
-                {
-                    if (player->is_real_player && !real_player_message_shown)
-                    {
-                        // Показываем сообщение только один раз за цикл
-                        std::cout << ">>> Ожидаем голос реального игрока " << player->id << "..." << std::endl;
-                        real_player_message_shown = true;
-                    }
-                    
-                    task.resume();
-                    all_done = false;
-                }
-            }
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (player->is_real_player)
+                *out << ">>> Ожидаем голос реального игрока " << player->id << "..." << std::endl;
+            scheduler.spawn(task);
         }
+        scheduler.run();
 
         // Собираем результаты
         for (auto& [player, task] : voting_tasks)
         {
             size_t vote_result = task.get_result();
-            votes[vote_result]++;
-            logger->log(Loglevel::INFO,
-                        TPrettyPrinter().f("Player ").f(player->id).f(" voted for player ").f(vote_result).Str());
-            std::cout << TPrettyPrinter().f("Игрок ").f(player->id).f(" голосует за игрока ").f(vote_result).Str() << std::endl;
-        }
-
-        auto key_val = std::max_element(votes.begin(), votes.end(),
-                                        [](const std::pair<int, int> &p1, const std::pair<int, int> &p2)
-                                        {
-                                            return p1.second < p2.second;
-                                        });
-
-        players[key_val->first]->alive = false;
-        logger->log(Loglevel::INFO,
-                    TPrettyPrinter().f("Player ").f(key_val->first).f(" was hanged in the city square by peaceful means of democracy and voting.").Str());
-        std::cout << TPrettyPrinter().f("Игрок ").f(key_val->first).f(" убит. За него проголосовало наибольшее число граждан.").Str() << std::endl
+            if (vote_result < votes.size())
+                votes[vote_result]++;
+            LOG(*this, INFO, "Player ", player->id, " voted for player ", vote_result);
+            record(EventType::Vote, player->id, vote_result);
+            *out << TPrettyPrinter().f("Игрок ").f(player->id).f(" голосует за игрока ").f(vote_result).Str() << std::endl;
+        }
+        voting_tasks.clear(); // ёмкость остаётся на следующий ход
+
+        // при равенстве — меньший id, как раньше у std::map
+        size_t hanged = size_t(std::max_element(votes.begin(), votes.end()) - votes.begin());
+
+        state.kill(hanged);
+        record(EventType::Hanged, kNobody, hanged, votes[hanged]);
+        LOG(*this, INFO, "Player ", hanged, " was hanged in the city square by peaceful means of democracy and voting.");
+        *out << TPrettyPrinter().f("Игрок ").f(hanged).f(" убит. За него проголосовало наибольшее число граждан.").Str() << std::endl
                 << std::endl;
     }
 
     void night_act()
     {
-        auto alives = players | view::filter([](auto p) { return p->alive; });
-        auto alives_ids_rng = alives | view::transform([](auto p) { return p->id; });
-        std::vector<size_t> alives_ids{alives_ids_rng.begin(), alives_ids_rng.end()};
+        FrameArenaScope frames{arena};
+        state.alive_ids_into(alive_buf);
+        const GameView view{state, alive_buf};
 
-        NightActions night_actions{players_num};
         night_actions.reset();
 
-        // Вектор для хранения задач ночных действий
-        std::vector<std::pair<SmartPtr<Player>, Task>> action_tasks;
-        
         // Запускаем все корутины ночных действий
-        for (const auto &player : alives)
+        auto &action_tasks = turn_tasks;
+        for (auto id : alive_buf)
         {
-            auto task = player->act(alives_ids, night_actions, players);
-            action_tasks.emplace_back(player, std::move(task));
+            action_tasks.emplace_back(players[id].get(), players[id]->act(view, night_actions, rng));
         }
 
-        // Обрабатываем корутины пока все не завершатся
-        bool real_player_message_shown = false;
-        bool all_done = false;
-        while (!all_done)
+        // ИИ отрабатывают за один проход очереди, живой игрок ждёт stdin в epoll
+        Scheduler scheduler;
+        for (auto& [player, task] : action_tasks)
         {
-            all_done = true;
-            
-            for (auto& [player, task] : action_tasks)
-            {
-                if (!task.done())
-                {
-                    if (player->is_real_player && !real_player_message_shown)
-                    {
-                        std::cout << ">>> Ожидаем ночное действие реального игрока " << player->id << "..." << std::endl;
-                        real_player_message_shown = true;
-                    }
-                    task.resume();
-                    all_done = false;
-                }
-            }
-            
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (player->is_real_player)
+                *out << ">>> Ожидаем ночное действие реального игрока " << player->id << "..." << std::endl;
+            scheduler.spawn(task);
         }
+        scheduler.run();
+        action_tasks.clear();
 
         // Бык -спец маф, которого не может завалить маньяк
-        for (size_t i = 0; i < night_actions.killers[bull_id].size(); i++)
+        for (size_t i = 0; bull_id < players_num && i < night_actions.killers[bull_id].size(); i++)
         {
             auto killer_id = night_actions.killers[bull_id][i];
-            if (players[killer_id]->role == "maniac")
+            if (state.role[killer_id] == Role::Maniac)
             {
                 night_actions.killers[bull_id].erase(night_actions.killers[bull_id].begin() + i);
                 break;
@@ -1309,72 +1255,255 @@ public:
 
         if (night_actions.commissar_action)
         {
-            logger->log(Loglevel::INFO, TPrettyPrinter().f("Commissar checked player ").f(night_actions.commissar_choice).f(". He was a ").f(players[night_actions.commissar_choice]->role).Str());
-            std::cout << "Этой ночью коммисар проверил игрока " << std::to_string(night_actions.commissar_choice) << std::endl;
+            LOG(*this, INFO, "Commissar checked player ", night_actions.commissar_choice, ". He was a ", role_name(state.role[night_actions.commissar_choice]));
+            record(EventType::Check, kNobody, night_actions.commissar_choice, unsigned(state.role[night_actions.commissar_choice]));
+            *out << "Этой ночью коммисар проверил игрока " << std::to_string(night_actions.commissar_choice) << std::endl;
         }
 
         if (night_actions.doctors_action)
         {
-            logger->log(Loglevel::INFO, TPrettyPrinter().f("Doctor healed player ").f(night_actions.doctors_choice).Str());
+            LOG(*this, INFO, "Doctor healed player ", night_actions.doctors_choice);
+            record(EventType::Heal, kNobody, night_actions.doctors_choice,
+                   !night_actions.killers[night_actions.doctors_choice].empty());
             // Лечение снимает все атаки с игрока
             night_actions.killers[night_actions.doctors_choice].clear();
-            std::cout << "Этой ночью доктор вылечил игрока " << std::to_string(night_actions.doctors_choice) << std::endl;
+            *out << "Этой ночью доктор вылечил игрока " << std::to_string(night_actions.doctors_choice) << std::endl;
         }
 
         if (night_actions.journalist_action)
         {
-            logger->log(Loglevel::INFO, TPrettyPrinter().f("Journalist checked players ").f(night_actions.journalist_choice.first).f(" and ").f(night_actions.journalist_choice.second).Str());
-            std::cout << "Этой ночью журналист сравнил игроков " << std::to_string(night_actions.journalist_choice.first) << " and " << std::to_string(night_actions.journalist_choice.second) << std::endl;
+            LOG(*this, INFO, "Journalist checked players ", night_actions.journalist_choice.first, " and ", night_actions.journalist_choice.second);
+            record(EventType::JournalistCheck, night_actions.journalist_choice.first, night_actions.journalist_choice.second,
+                   state.team[night_actions.journalist_choice.first] == state.team[night_actions.journalist_choice.second]);
+            *out << "Этой ночью журналист сравнил игроков " << std::to_string(night_actions.journalist_choice.first) << " and " << std::to_string(night_actions.journalist_choice.second) << std::endl;
         }
 
         if (night_actions.commisarfan_action)
         {
-            logger->log(Loglevel::INFO, TPrettyPrinter().f("Commisarfan checked player ").f(night_actions.commisarfan_choice).Str());
-            std::cout << "Этой ночью поклонница коммисара проверила игрока " << std::to_string(night_actions.commisarfan_choice) << std::endl;
+            LOG(*this, INFO, "Commisarfan checked player ", night_actions.commisarfan_choice);
+            record(EventType::FanCheck, kNobody, night_actions.commisarfan_choice,
+                   state.role[night_actions.commisarfan_choice] == Role::Commissar);
+            *out << "Этой ночью поклонница коммисара проверила игрока " << std::to_string(night_actions.commisarfan_choice) << std::endl;
         }
         // обработка убийстви
         for (size_t i = 0; i < players_num; i++)
         {
             if (!night_actions.killers[i].empty())
             {
-                auto log_message = TPrettyPrinter().f("Player ").f(i).f(" was killed by ").Str();
-                std::string msg = "игрок " + std::to_string(i) + " был убит ";
-                for (size_t j = 0; j < night_actions.killers[i].size(); j++)
-                {
-                    log_message += players[night_actions.killers[i][j]]->role;
-                    msg += players[night_actions.killers[i][j]]->role;
-
-                    log_message += (j == night_actions.killers[i].size() - 1) ? "" : ", ";
-                    msg += (j == night_actions.killers[i].size() - 1) ? "" : ", ";
-                }
+                for (size_t killer : night_actions.killers[i])
+                    record(EventType::Kill, killer, i);
                 // убиваем
-                players[i]->alive = false;
+                state.kill(i);
 
-                logger->log(Loglevel::INFO, log_message);
-                std::cout << "Этой ночью " << msg << std::endl;
+                // строку собираем, только если её есть кому показать: в симуляции ночь не аллоцирует
+                if (!headless || log_enabled(Loglevel::INFO))
+                {
+                    std::string killed_by;
+                    for (size_t j = 0; j < night_actions.killers[i].size(); j++)
+                    {
+                        killed_by += role_name(state.role[night_actions.killers[i][j]]);
+                        killed_by += (j == night_actions.killers[i].size() - 1) ? "" : ", ";
+                    }
+                    LOG(*this, INFO, "Player ", i, " was killed by ", killed_by);
+                    *out << "Этой ночью игрок " << i << " был убит " << killed_by << std::endl;
+                }
             }
         }
     }
 };
 
-int main(void)
+// Итоги серии партий. У каждого потока свой экземпляр (на своей кэш-линии),
+// сливаются после join — блокировок и разделяемых счётчиков нет
+struct alignas(64) SimStats
+{
+    static constexpr std::array<const char *, 4> outcomes{"civilian", "mafia", "maniac", "draw"};
+
+    std::array<unsigned long, outcomes.size()> wins{};
+    unsigned long long total_days = 0;
+    unsigned long games = 0;
+
+    void add(const std::string &status, unsigned int days)
+    {
+        for (size_t i = 0; i < outcomes.size(); i++)
+        {
+            if (status == outcomes[i])
+                wins[i]++;
+        }
+        total_days += days;
+        games++;
+    }
+
+    SimStats &operator+=(const SimStats &other)
+    {
+        for (size_t i = 0; i < outcomes.size(); i++)
+            wins[i] += other.wins[i];
+        total_days += other.total_days;
+        games += other.games;
+        return *this;
+    }
+};
+
+// Одна безголовая партия с сидом game_seed(base_seed, index); при записи события уходят в writer
+inline void simulate_game(const std::vector<std::string> &roles, uint64_t base_seed, uint64_t index, SimStats &stats,
+                          EventRecorder *recorder = nullptr, EventLogWriter *writer = nullptr)
+{
+    uint64_t seed = game_seed(base_seed, index);
+    auto game = Game<Player>(roles.size(), 3, seed);
+    game.set_headless(true);
+    if (recorder)
+    {
+        recorder->begin(seed, index, roles.size());
+        game.recorder = recorder;
+    }
+    game.init_players(roles);
+    std::string status = game.main_loop();
+    stats.add(status, game.days_played);
+    if (recorder && writer)
+        writer->write_game(*recorder);
+}
+
+// Безголовая симуляция: только ИИ, без консоли и логов, на threads потоках.
+// Партии раздаются кусками через атомарный счётчик; исход каждой зависит только
+// от base_seed и её номера, поэтому итог не зависит от числа потоков.
+// Печатает долю побед каждой команды и среднюю длину партии в днях.
+// record_path — бинарный журнал событий всех партий (пусто — не писать).
+int run_simulation(const std::string &config_path, unsigned long games, uint64_t base_seed, unsigned int threads,
+                   const std::string &record_path = "")
+{
+    std::vector<std::string> roles = parseRolesFromConfigSimple(config_path);
+    if (roles.empty() || games == 0)
+    {
+        std::cerr << "Нечего симулировать: " << config_path << std::endl;
+        return 1;
+    }
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    if (!record_path.empty() && !create_event_log(record_path))
+    {
+        std::cerr << "Не удалось создать журнал событий: " << record_path << std::endl;
+        return 1;
+    }
+
+    constexpr unsigned long chunk = 256;
+    std::atomic<unsigned long> next{0};
+    std::atomic<bool> record_failed{false};
+    std::vector<SimStats> per_thread(threads);
+
+    auto worker = [&](SimStats &stats)
+    {
+        // у каждого потока свой буфер событий и свой дескриптор журнала
+        std::optional<EventLogWriter> writer;
+        EventRecorder recorder;
+        if (!record_path.empty())
+            writer.emplace(record_path);
+        for (;;)
+        {
+            unsigned long begin = next.fetch_add(chunk, std::memory_order_relaxed);
+            if (begin >= games)
+                break;
+            unsigned long end = std::min(games, begin + chunk);
+            for (unsigned long i = begin; i < end; i++)
+                simulate_game(roles, base_seed, i, stats, writer ? &recorder : nullptr, writer ? &*writer : nullptr);
+        }
+        // хвост пишем здесь, а не в деструкторе, чтобы узнать об ошибке
+        if (writer && !writer->flush())
+            record_failed.store(true, std::memory_order_relaxed);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        pool.emplace_back(worker, std::ref(per_thread[t]));
+    worker(per_thread[0]);
+    for (auto &th : pool)
+        th.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    SimStats total;
+    for (const auto &st : per_thread)
+        total += st;
+
+    std::cout << "Игр: " << total.games << ", игроков: " << roles.size()
+              << ", сид: " << base_seed << ", потоков: " << threads << std::endl;
+    for (size_t i = 0; i < SimStats::outcomes.size(); i++)
+    {
+        std::cout << SimStats::outcomes[i] << ": " << total.wins[i] << " ("
+                  << 100.0 * total.wins[i] / total.games << "%)" << std::endl;
+    }
+    std::cout << "Средняя длина партии: " << double(total.total_days) / total.games << " дн." << std::endl;
+    std::cout << "Скорость: " << (seconds > 0 ? total.games / seconds : 0.0) << " игр/с" << std::endl;
+    if (record_failed.load())
+    {
+        std::cerr << "Журнал событий записан не полностью: " << record_path << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Пересказ записанной партии и проверка детерминизма: партия переигрывается
+// с тем же сидом и ролями, события должны совпасть один в один
+int replay_game(const std::string &path, uint64_t index)
 {
-    // int i = 7;
-    // std::time_t result = std::time(nullptr);
-    //  std::srand((int) result);
+    EventLogView log_view(path);
+    GameRecord game;
+    if (!log_view.ok() || !log_view.find(index, game))
+    {
+        std::cerr << "Партия " << index << " не найдена в " << path << std::endl;
+        return 1;
+    }
+    print_game(game, std::cout);
+
+    EventRecorder recorder;
+    recorder.begin(game.header->seed, index, game.header->players);
+    auto replay = Game<Player>(game.header->players, 3, game.header->seed);
+    replay.set_headless(true);
+    replay.recorder = &recorder;
+    replay.init_players(setup_roles(game));
+    replay.main_loop();
+
+    auto [rec_it, log_it] = std::ranges::mismatch(recorder.events, game.events);
+    if (rec_it == recorder.events.end() && log_it == game.events.end())
+    {
+        std::cout << "Повтор совпал с записью: " << game.events.size() << " событий" << std::endl;
+        return 0;
+    }
+    std::cout << "Повтор расходится с записью на событии " << (log_it - game.events.begin()) << std::endl;
+    return 2;
+}
 
-    std::srand(5);
-    std::cout << "========== SRAND = " << 5 << " ==========" << std::endl;
+int main(int argc, char **argv)
+{
+    const uint64_t seed = 5;
+
+    // ./main.out --sim [config.yaml] [N] [seed] [threads] [events.bin]
+    if (argc > 1 && std::string(argv[1]) == "--sim")
+    {
+        std::string config_path = argc > 2 ? argv[2] : "./config.yaml";
+        unsigned long games = argc > 3 ? std::stoul(argv[3]) : 10000;
+        uint64_t base_seed = argc > 4 ? std::stoull(argv[4]) : seed;
+        unsigned int threads = argc > 5 ? std::stoul(argv[5]) : 0;
+        std::string record_path = argc > 6 ? argv[6] : "";
+        return run_simulation(config_path, games, base_seed, threads, record_path);
+    }
+
+    // ./main.out --replay events.bin game_index
+    if (argc > 3 && std::string(argv[1]) == "--replay")
+    {
+        return replay_game(argv[2], std::stoull(argv[3]));
+    }
+
+    // Свой буфер у std::cin: планировщик видит недочитанный ввод через in_avail()
+    std::ios::sync_with_stdio(false);
+
+    std::cout << "========== SEED = " << seed << " ==========" << std::endl;
 
     std::string check;
     std::cout << "Выберите как будут определятся роли в игре. Автоматически (g) или через конфигурационный файл (f)" << std::endl;
     std::cin >> check;
     std::vector<std::string> roles;
 
-    // default инициализация
-    auto game = Game<Player>(1); 
-
-
+    // Игроки живут в арене партии и ссылаются на неё, поэтому Game создаётся на месте, без переприсваивания
+    std::optional<Game<Player>> game;
 
     if (check == "g")
     {
@@ -1382,19 +1511,19 @@ int main(void)
         std::cout << "Сколько всего будет игроков?" << std::endl;
         std::cin >> n;
 
-        game = Game<Player>(n);
-        roles = game.get_random_roles();
+        game.emplace(n, 3, seed);
+        roles = game->get_random_roles();
     }
     else
     {
         roles = parseRolesFromConfigSimple("./config.yaml");
-        game = Game<Player>(roles.size());
+        game.emplace(roles.size(), 3, seed);
     }
 
     // инициализация игроков
-    game.init_players(roles);
+    game->init_players(roles);
 
-    game.main_loop();
+    game->main_loop();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include <cctype>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "arena.cpp"
+
+class Scheduler;
+
+// Арена, из которой берутся кадры корутин этого потока (nullptr — обычная куча)
+inline thread_local Arena *frame_arena = nullptr;
+
+// Пока объект жив, новые кадры корутин потока берутся из arena
+class FrameArenaScope {
+public:
+    explicit FrameArenaScope(Arena &arena) : previous(frame_arena) { frame_arena = &arena; }
+    FrameArenaScope(const FrameArenaScope&) = delete;
+    FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+    ~FrameArenaScope() { frame_arena = previous; }
+
+private:
+    Arena *previous;
+};
+
+struct Task {
+    struct promise_type {
+        size_t result;
+        std::coroutine_handle<> continuation{}; // кто ждёт нас через co_await
+        Scheduler *scheduler = nullptr;         // наследуется от ожидающей корутины
+
+        // По завершении передаём управление ожидающему напрямую (symmetric transfer),
+        // корневая задача возвращается в цикл планировщика
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                auto next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {}
+        };
+
+        // Кадр корутины — из frame_arena, если она задана, иначе из кучи.
+        // Перед кадром лежит заголовок с ареной: delete вернёт память туда, откуда она взята,
+        // даже если кадр разрушают уже вне FrameArenaScope
+        static constexpr std::size_t kFrameHeader = alignof(std::max_align_t);
+
+        static void *operator new(std::size_t size) {
+            Arena *arena = frame_arena;
+            void *raw = arena ? arena->allocate(size + kFrameHeader) : ::operator new(size + kFrameHeader);
+            *static_cast<Arena **>(raw) = arena;
+            return static_cast<char *>(raw) + kFrameHeader;
+        }
+
+        static void operator delete(void *frame, std::size_t size) noexcept {
+            void *raw = static_cast<char *>(frame) - kFrameHeader;
+            Arena *arena = *static_cast<Arena **>(raw);
+            if (arena)
+                arena->deallocate(raw, size + kFrameHeader);
+            else
+                ::operator delete(raw);
+        }
+
+        Task get_return_object() {
+            return Task{ std::coroutine_handle<promise_type>::from_promise(*this) };
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_value(size_t value) {
+            result = value;
+        }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    Task(std::coroutine_handle<promise_type> h) : handle(h) {}
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+    ~Task() { if (handle) handle.destroy(); }
+
+    bool done() const {
+        return !handle || handle.done();
+    }
+
+    size_t get_result() const {
+        return handle.promise().result;
+    }
+
+    // co_await Task: запоминаем ожидающего и сразу прыгаем в дочернюю корутину
+    bool await_ready() const noexcept {
+        return done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        handle.promise().scheduler = awaiting.promise().scheduler;
+        return handle;
+    }
+
+    size_t await_resume() const noexcept {
+        return get_result();
+    }
+};
+
+// Планировщик корутин одного хода (голосование или ночь).
+// Готовые корутины лежат в очереди и выполняются подряд; корутина, ждущая ввода,
+// паркуется на своём дескрипторе в epoll и возвращается в очередь, когда он станет читаемым.
+// Если никто не ждёт ввода, epoll даже не создаётся — ИИ отрабатывают за один проход.
+class Scheduler {
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+    ~Scheduler() { if (epoll_fd >= 0) close(epoll_fd); }
+
+    // Ставит корневую задачу в очередь; результат забирается из неё после run()
+    void spawn(Task &task) {
+        if (task.done())
+            return;
+        task.handle.promise().scheduler = this;
+        ready.push_back(task.handle);
+    }
+
+    void schedule(std::coroutine_handle<> h) {
+        ready.push_back(h);
+    }
+
+    // Припарковать h до готовности fd на чтение. Дескрипторы, которые epoll
+    // не поддерживает (обычный файл вместо терминала), всегда готовы
+    void wait_readable(int fd, std::coroutine_handle<> h) {
+        auto &waiters = parked[fd];
+        if (waiters.empty() && !watch(fd)) {
+            parked.erase(fd);
+            schedule(h);
+            return;
+        }
+        waiters.push_back(h);
+    }
+
+    // Крутит очередь, пока есть готовые или ждущие ввода корутины
+    void run() {
+        while (!ready.empty() || !parked.empty()) {
+            while (!ready.empty()) {
+                auto h = ready.front();
+                ready.pop_front();
+                h.resume();
+            }
+            if (!parked.empty())
+                poll();
+        }
+    }
+
+private:
+    bool watch(int fd) {
+        if (epoll_fd < 0)
+            epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        return epoll_fd >= 0 && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+    }
+
+    // Блокируется в epoll_wait без таймаута: ожидание человека не тратит CPU
+    void poll() {
+        epoll_event events[8];
+        int n = epoll_wait(epoll_fd, events, 8, -1);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            auto it = parked.find(fd);
+            if (it == parked.end())
+                continue;
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+            for (auto h : it->second)
+                schedule(h);
+            parked.erase(it);
+        }
+    }
+
+    std::deque<std::coroutine_handle<>> ready;
+    std::map<int, std::vector<std::coroutine_handle<>>> parked;
+    int epoll_fd = -1;
+};
+
+// co_await readable(fd): ждать, пока в fd (stdin, сокет) появятся данные.
+// Для stdin сначала смотрим буфер std::cin — там может лежать остаток строки
+// (работает при sync_with_stdio(false), иначе буфер всегда пуст)
+struct ReadableAwaiter {
+    int fd;
+    std::streambuf *buffer = nullptr;
+
+    bool await_ready() const {
+        if (!buffer)
+            return false;
+        // хвостовые пробелы и переводы строк не считаются вводом
+        while (buffer->in_avail() > 0 && std::isspace(buffer->sgetc()))
+            buffer->sbumpc();
+        return buffer->in_avail() > 0;
+    }
+    // Вне планировщика не засыпаем — дальше будет обычное блокирующее чтение
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h) const {
+        if (!h.promise().scheduler)
+            return false;
+        h.promise().scheduler->wait_readable(fd, h);
+        return true;
+    }
+    void await_resume() const noexcept {}
+};
+
+inline ReadableAwaiter readable(int fd) {
+    return ReadableAwaiter{fd};
+}
+
+inline ReadableAwaiter stdin_readable() {
+    return ReadableAwaiter{STDIN_FILENO, std::cin.rdbuf()};
+}
@@ -1,38 +1,190 @@
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <utility>
 
-template<typename T>
+// Политики счётчика ссылок.
+// PlainRefCount — обычные инкременты: владение в пределах одного потока (игроки партии).
+// AtomicRefCount — атомарные: указатель можно копировать и отпускать из разных потоков.
+struct PlainRefCount {
+    std::size_t value;
+
+    explicit PlainRefCount(std::size_t v) : value(v) {}
+    void increment() noexcept { ++value; }
+    // true, если счётчик дошёл до нуля
+    bool decrement() noexcept { return --value == 0; }
+    // для WeakPtr::lock(): не воскрешаем уже удалённый объект
+    bool increment_if_nonzero() noexcept {
+        if (value == 0) return false;
+        ++value;
+        return true;
+    }
+    std::size_t load() const noexcept { return value; }
+};
+
+struct AtomicRefCount {
+    std::atomic<std::size_t> value;
+
+    explicit AtomicRefCount(std::size_t v) : value(v) {}
+    // новая ссылка берётся от живой, упорядочивать нечего
+    void increment() noexcept { value.fetch_add(1, std::memory_order_relaxed); }
+    // acq_rel: записи всех владельцев видны тому, кто удаляет
+    bool decrement() noexcept { return value.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+    bool increment_if_nonzero() noexcept {
+        std::size_t cur = value.load(std::memory_order_relaxed);
+        while (cur != 0) {
+            if (value.compare_exchange_weak(cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+    std::size_t load() const noexcept { return value.load(std::memory_order_relaxed); }
+};
+
+// Блок управления: сильные и слабые ссылки.
+// weak = число WeakPtr + 1, пока жива хоть одна сильная ссылка;
+// объект разрушается при strong == 0, сам блок — при weak == 0
+template<typename RefCount>
+struct ControlBlock {
+    RefCount strong{1};
+    RefCount weak{1};
+
+    virtual ~ControlBlock() = default;
+    virtual void destroy_object() noexcept = 0;
+    // освобождает сам блок; по умолчанию он из обычной кучи
+    virtual void destroy_block() noexcept { delete this; }
+
+    void release_strong() noexcept {
+        if (strong.decrement()) {
+            destroy_object();
+            release_weak();
+        }
+    }
+
+    void release_weak() noexcept {
+        if (weak.decrement())
+            destroy_block();
+    }
+};
+
+// SmartPtr(new T): объект и блок — две аллокации
+template<typename T, typename RefCount>
+struct PointerBlock final : ControlBlock<RefCount> {
+    T* object;
+
+    explicit PointerBlock(T* p) : object(p) {}
+    void destroy_object() noexcept override { delete object; }
+};
+
+// make_smart: объект лежит прямо в блоке — одна аллокация
+template<typename T, typename RefCount>
+struct InplaceBlock : ControlBlock<RefCount> {
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    template<typename... Args>
+    explicit InplaceBlock(Args&&... args) {
+        ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+    }
+    T* object() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    void destroy_object() noexcept override { object()->~T(); }
+};
+
+// allocate_smart: тот же блок, но в памяти аллокатора (например, арены партии).
+// Alloc — любой тип с allocate(size, align) и deallocate(p, size, align)
+template<typename T, typename RefCount, typename Alloc>
+struct AllocatedBlock final : InplaceBlock<T, RefCount> {
+    Alloc* alloc;
+
+    template<typename... Args>
+    explicit AllocatedBlock(Alloc& a, Args&&... args) : InplaceBlock<T, RefCount>(std::forward<Args>(args)...), alloc(&a) {}
+
+    void destroy_block() noexcept override {
+        Alloc* a = alloc;
+        this->~AllocatedBlock();
+        a->deallocate(this, sizeof(AllocatedBlock), alignof(AllocatedBlock));
+    }
+};
+
+template<typename T, typename RefCount = PlainRefCount>
+class SmartPtr;
+
+template<typename T, typename RefCount = PlainRefCount>
+class WeakPtr;
+
+// Объект и счётчики одной аллокацией: make_smart<Dummy>(42), make_smart<Dummy, AtomicRefCount>(42)
+template<typename T, typename RefCount = PlainRefCount, typename... Args>
+SmartPtr<T, RefCount> make_smart(Args&&... args);
+
+// То же из памяти alloc: allocate_smart<Dummy>(arena, 42)
+template<typename T, typename RefCount = PlainRefCount, typename Alloc, typename... Args>
+SmartPtr<T, RefCount> allocate_smart(Alloc& alloc, Args&&... args);
+
+template<typename T, typename RefCount>
 class SmartPtr {
 private:
     T* ptr;
-    std::size_t* ref_count;
-
-    void release() {
-        if (ref_count) {
-            (*ref_count)--;
-            if (*ref_count == 0) {
-                delete ptr;
-                delete ref_count;
-            }
-        }
+    ControlBlock<RefCount>* block;
+
+    template<typename U, typename R> friend class SmartPtr;
+    template<typename U, typename R> friend class WeakPtr;
+    template<typename U, typename R, typename... Args>
+    friend SmartPtr<U, R> make_smart(Args&&... args);
+    template<typename U, typename R, typename A, typename... Args>
+    friend SmartPtr<U, R> allocate_smart(A& alloc, Args&&... args);
+
+    // Забирает уже посчитанную ссылку (make_smart, allocate_smart, WeakPtr::lock)
+    SmartPtr(T* p, ControlBlock<RefCount>* b) noexcept : ptr(p), block(b) {}
+
+    void release() noexcept {
+        if (block) block->release_strong();
     }
 
 public:
     // Конструкторы
-    SmartPtr() : ptr(nullptr), ref_count(nullptr) {}
+    SmartPtr() noexcept : ptr(nullptr), block(nullptr) {}
 
-    explicit SmartPtr(T* p) : ptr(p), ref_count(new std::size_t(1)) {}
+    // Если блок не выделился, p всё равно удаляется — владение уже передано, как у std::shared_ptr
+    explicit SmartPtr(T* p) : ptr(p), block(nullptr) {
+        if (!p) return;
+        try {
+            block = new PointerBlock<T, RefCount>(p);
+        } catch (...) {
+            delete p;
+            throw;
+        }
+    }
 
-    SmartPtr(const SmartPtr& other) : ptr(other.ptr), ref_count(other.ref_count) {
-        if (ref_count) (*ref_count)++;
+    SmartPtr(const SmartPtr& other) noexcept : ptr(other.ptr), block(other.block) {
+        if (block) block->strong.increment();
     }
 
-    SmartPtr& operator=(const SmartPtr& other) {
-        if (this != &other) {
-            release();
-            ptr = other.ptr;
-            ref_count = other.ref_count;
-            if (ref_count) (*ref_count)++;
-        }
+    // Перемещение забирает ссылку как есть: счётчик не трогаем
+    SmartPtr(SmartPtr&& other) noexcept : ptr(other.ptr), block(other.block) {
+        other.ptr = nullptr;
+        other.block = nullptr;
+    }
+
+    // SmartPtr<Derived> -> SmartPtr<Base>
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    SmartPtr(const SmartPtr<U, RefCount>& other) noexcept : ptr(other.ptr), block(other.block) {
+        if (block) block->strong.increment();
+    }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    SmartPtr(SmartPtr<U, RefCount>&& other) noexcept : ptr(other.ptr), block(other.block) {
+        other.ptr = nullptr;
+        other.block = nullptr;
+    }
+
+    // copy-and-swap: и копирование, и перемещение, самоприсваивание безопасно
+    SmartPtr& operator=(const SmartPtr& other) noexcept {
+        SmartPtr(other).swap(*this);
+        return *this;
+    }
+
+    SmartPtr& operator=(SmartPtr&& other) noexcept {
+        SmartPtr(std::move(other)).swap(*this);
         return *this;
     }
 
@@ -44,29 +196,108 @@ public:
     T& operator*() const { return *ptr; }
     T* operator->() const { return ptr; }
     T* get() const { return ptr; }
+    explicit operator bool() const noexcept { return ptr != nullptr; }
 
     // Методы
     void reset(T* p = nullptr) { //начинаем владеть НОВЫМ объектом или nullptr
-        release();
-        if (p) {
-            ptr = p;
-            ref_count = new std::size_t(1);
-        } else {
-            ptr = nullptr;
-            ref_count = nullptr;
-        }
+        SmartPtr(p).swap(*this);
     }
 
-    void swap(SmartPtr& other) {
+    void swap(SmartPtr& other) noexcept {
         std::swap(ptr, other.ptr);
-        std::swap(ref_count, other.ref_count);
+        std::swap(block, other.block);
     }
 
     std::size_t use_count() const {
-        return ref_count ? *ref_count : 0;
+        return block ? block->strong.load() : 0;
     }
 
     // Сравнение
     bool operator==(const SmartPtr& other) const { return ptr == other.ptr; }
     bool operator!=(const SmartPtr& other) const { return ptr != other.ptr; }
 };
+
+// Для объектов, которые делят между потоками
+template<typename T>
+using AtomicSmartPtr = SmartPtr<T, AtomicRefCount>;
+
+template<typename T, typename RefCount, typename... Args>
+SmartPtr<T, RefCount> make_smart(Args&&... args) {
+    auto* b = new InplaceBlock<T, RefCount>(std::forward<Args>(args)...);
+    return SmartPtr<T, RefCount>(b->object(), b);
+}
+
+template<typename T, typename RefCount, typename Alloc, typename... Args>
+SmartPtr<T, RefCount> allocate_smart(Alloc& alloc, Args&&... args) {
+    using Block = AllocatedBlock<T, RefCount, Alloc>;
+    void* mem = alloc.allocate(sizeof(Block), alignof(Block));
+    Block* b;
+    try {
+        b = ::new (mem) Block(alloc, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate(mem, sizeof(Block), alignof(Block));
+        throw;
+    }
+    return SmartPtr<T, RefCount>(b->object(), b);
+}
+
+// Слабая ссылка: не продлевает жизнь объекта, но держит блок,
+// чтобы lock() мог узнать, жив ли объект
+template<typename T, typename RefCount>
+class WeakPtr {
+private:
+    T* ptr;
+    ControlBlock<RefCount>* block;
+
+public:
+    WeakPtr() noexcept : ptr(nullptr), block(nullptr) {}
+
+    WeakPtr(const SmartPtr<T, RefCount>& owner) noexcept : ptr(owner.ptr), block(owner.block) {
+        if (block) block->weak.increment();
+    }
+
+    WeakPtr(const WeakPtr& other) noexcept : ptr(other.ptr), block(other.block) {
+        if (block) block->weak.increment();
+    }
+
+    WeakPtr(WeakPtr&& other) noexcept : ptr(other.ptr), block(other.block) {
+        other.ptr = nullptr;
+        other.block = nullptr;
+    }
+
+    WeakPtr& operator=(const WeakPtr& other) noexcept {
+        WeakPtr(other).swap(*this);
+        return *this;
+    }
+
+    WeakPtr& operator=(WeakPtr&& other) noexcept {
+        WeakPtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~WeakPtr() {
+        if (block) block->release_weak();
+    }
+
+    // Сильная ссылка, если объект ещё жив, иначе пустой SmartPtr
+    SmartPtr<T, RefCount> lock() const noexcept {
+        if (block && block->strong.increment_if_nonzero())
+            return SmartPtr<T, RefCount>(ptr, block);
+        return SmartPtr<T, RefCount>();
+    }
+
+    bool expired() const noexcept { return use_count() == 0; }
+
+    std::size_t use_count() const noexcept {
+        return block ? block->strong.load() : 0;
+    }
+
+    void reset() noexcept {
+        WeakPtr().swap(*this);
+    }
+
+    void swap(WeakPtr& other) noexcept {
+        std::swap(ptr, other.ptr);
+        std::swap(block, other.block);
+    }
+};
@@ -1,5 +1,9 @@
 #include <iostream>
 #include <cassert>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
 #include "smart_ptr.cpp"
 
 struct Dummy {
@@ -8,6 +12,51 @@ struct Dummy {
     ~Dummy() { std::cout << "Dummy(" << value << ") destroyed\n"; }
 };
 
+// Считает, сколько раз объект выделялся отдельно через new
+struct Tracked {
+    static inline int allocations = 0;
+    int value;
+    explicit Tracked(int v) : value(v) {}
+    static void* operator new(std::size_t size) {
+        allocations++;
+        return ::operator new(size);
+    }
+    static void operator delete(void* p) { ::operator delete(p); }
+};
+
+// Аллокатор для allocate_smart: считает выданные и возвращённые блоки
+struct CountingAlloc {
+    int live = 0;
+    void* allocate(std::size_t size, std::size_t align) {
+        live++;
+        return ::operator new(size, std::align_val_t(align));
+    }
+    void deallocate(void* p, std::size_t, std::size_t align) noexcept {
+        live--;
+        ::operator delete(p, std::align_val_t(align));
+    }
+};
+
+struct Base {
+    virtual ~Base() = default;
+    virtual int kind() const { return 0; }
+};
+
+struct Derived : Base {
+    int kind() const override { return 1; }
+};
+
+// Без вывода, для стресс-тестов: считаем разрушения
+struct Counted {
+    static inline std::atomic<int> destroyed{0};
+    int value;
+    explicit Counted(int v) : value(v) {}
+    ~Counted() {
+        value = -1;
+        destroyed.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
 int main() {
     std::cout << "=== TEST 1: Basic creation ===\n";
     {
@@ -82,6 +131,131 @@ int main() {
         std::cout << "OK\n";
     }
 
+    std::cout << "=== TEST 8: Move semantics ===\n";
+    {
+        SmartPtr<Dummy> a(new Dummy(5));
+        SmartPtr<Dummy> b = std::move(a);
+        assert(a.get() == nullptr);
+        assert(b.use_count() == 1);
+        SmartPtr<Dummy> c;
+        c = std::move(b);
+        assert(!b);
+        assert(c.use_count() == 1 && c->value == 5);
+        c = std::move(c); // самоприсваивание
+        assert(c.use_count() == 1 && c->value == 5);
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 9: make_smart() places object in control block ===\n";
+    {
+        SmartPtr<Tracked> separate(new Tracked(1));
+        assert(Tracked::allocations == 1);
+        auto p = make_smart<Tracked>(7);
+        auto q = make_smart<Tracked, AtomicRefCount>(8);
+        assert(Tracked::allocations == 1); // объект внутри блока, отдельного new не было
+        assert(p.use_count() == 1 && p->value == 7);
+        assert(q.use_count() == 1 && q->value == 8);
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 10: Derived to Base ===\n";
+    {
+        SmartPtr<Derived> d = make_smart<Derived>();
+        SmartPtr<Base> b = d;
+        assert(b.use_count() == 2);
+        assert(b->kind() == 1);
+        SmartPtr<Base> moved = make_smart<Derived>();
+        assert(moved.use_count() == 1 && moved->kind() == 1);
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 11: Weak references ===\n";
+    {
+        WeakPtr<Dummy> w;
+        assert(w.expired());
+        {
+            auto p = make_smart<Dummy>(11);
+            w = p;
+            assert(w.use_count() == 1);
+            auto locked = w.lock();
+            assert(locked && locked->value == 11);
+            assert(p.use_count() == 2);
+        }
+        // объект разрушен, блок ещё держит слабая ссылка
+        assert(w.expired());
+        assert(!w.lock());
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 12: Concurrent copies (AtomicRefCount) ===\n";
+    {
+        constexpr int kThreads = 8;
+        constexpr int kIterations = 100000;
+        Counted::destroyed = 0;
+        {
+            auto shared = make_smart<Counted, AtomicRefCount>(42);
+            std::vector<std::thread> pool;
+            for (int t = 0; t < kThreads; t++) {
+                pool.emplace_back([shared] {
+                    for (int i = 0; i < kIterations; i++) {
+                        AtomicSmartPtr<Counted> copy = shared;
+                        AtomicSmartPtr<Counted> moved = std::move(copy);
+                        assert(moved->value == 42);
+                    }
+                });
+            }
+            for (auto& th : pool)
+                th.join();
+            assert(shared.use_count() == 1);
+            assert(Counted::destroyed == 0);
+        }
+        assert(Counted::destroyed == 1);
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 13: Last owner released on another thread ===\n";
+    {
+        constexpr int kRounds = 2000;
+        Counted::destroyed = 0;
+        for (int round = 0; round < kRounds; round++) {
+            auto owner = make_smart<Counted, AtomicRefCount>(round);
+            WeakPtr<Counted, AtomicRefCount> weak = owner;
+            std::atomic<bool> go{false};
+            // читатели пытаются поднять слабую ссылку, пока главный поток отпускает объект
+            auto reader = [&weak, &go, round] {
+                while (!go.load(std::memory_order_acquire)) {}
+                for (int i = 0; i < 50; i++) {
+                    if (auto p = weak.lock())
+                        assert(p->value == round);
+                }
+            };
+            std::thread r1(reader), r2(reader);
+            go.store(true, std::memory_order_release);
+            owner.reset();
+            r1.join();
+            r2.join();
+            assert(weak.expired());
+        }
+        assert(Counted::destroyed == kRounds);
+        std::cout << "OK\n";
+    }
+
+    std::cout << "=== TEST 14: allocate_smart() with custom allocator ===\n";
+    {
+        CountingAlloc alloc;
+        WeakPtr<Tracked> w;
+        {
+            SmartPtr<Tracked> p = allocate_smart<Tracked>(alloc, 14);
+            w = p;
+            assert(alloc.live == 1 && p->value == 14);
+        }
+        // объект разрушен, но блок держит слабая ссылка
+        assert(w.expired() && alloc.live == 1);
+        w.reset();
+        assert(alloc.live == 0);
+        std::cout << "OK\n";
+    }
+
     std::cout << "=== ALL TESTS PASSED SUCCESSFULLY ===\n";
     return 0;
 }
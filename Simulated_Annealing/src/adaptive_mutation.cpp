@@ -0,0 +1,57 @@
+#include "mutations.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace {
+uint64_t cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+} // namespace
+
+AdaptiveMutation::AdaptiveMutation(std::vector<std::unique_ptr<IMutation>> ops, double decay_, double explore_)
+    : decay(decay_), explore(explore_) {
+    for (auto& op : ops) arms.push_back(Arm{std::move(op)});
+}
+
+size_t AdaptiveMutation::pick() const {
+    // сначала каждый оператор хотя бы раз
+    for (size_t k = 0; k < arms.size(); ++k)
+        if (arms[k].pulls == 0) return k;
+
+    double bestMean = 0;
+    for (const auto& a : arms) bestMean = std::max(bestMean, a.reward / a.n);
+    size_t best = 0;
+    double bestScore = -1;
+    for (size_t k = 0; k < arms.size(); ++k) {
+        const auto& a = arms[k];
+        double mean = bestMean > 0 ? (a.reward / a.n) / bestMean : 0.0; // нормируем в [0,1]
+        double score = mean + explore * std::sqrt(std::log(std::max(total, 1.0)) / a.n);
+        if (score > bestScore) { bestScore = score; best = k; }
+    }
+    return best;
+}
+
+void AdaptiveMutation::apply(ISolution& s, std::mt19937_64& rng) {
+    if (arms.empty()) return;
+    last = pick();
+    Arm& a = arms[last];
+
+    uint64_t t0 = cpu_ns();
+    a.op->apply(s, rng);
+    lastNs = std::max<uint64_t>(cpu_ns() - t0, 1);
+
+    for (auto& x : arms) { x.n *= decay; x.reward *= decay; }
+    total = total * decay + 1;
+    a.n += 1;
+    ++a.pulls;
+}
+
+void AdaptiveMutation::feedback(double delta) {
+    if (last >= arms.size()) return;
+    arms[last].reward += std::max(0.0, -delta) / double(lastNs);
+    arms[last].op->feedback(delta);
+    last = SIZE_MAX;
+}
@@ -0,0 +1,156 @@
+#include "affinity.hpp"
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+namespace {
+constexpr int kMpolBind = 2;         // MPOL_BIND из linux/mempolicy.h
+constexpr unsigned kMpolMfMove = 2;  // MPOL_MF_MOVE
+
+// Один прогон ИО в уже форкнутом воркере
+WorkerRate run_worker(const Instance& I, SAParams sa, uint32_t rank, bool pin, int firstCore,
+                      std::unique_ptr<IMutation> mut, std::unique_ptr<ITempSchedule> temp) {
+    WorkerRate r;
+    r.rank = rank;
+    if (pin) {
+        r.cpu = worker_cpu(rank, firstCore);
+        if (r.cpu < 0 || !pin_to_cpu(r.cpu)) r.cpu = -1;
+        else r.node = numa_node_of_cpu(r.cpu);
+    }
+    Instance local = pin ? replicate_instance(I, r.node) : I;
+
+    sa.seed += rank;
+    std::mt19937_64 rng(sa.seed);
+    auto init = std::make_unique<ScheduleSolution>(&local);
+    init->randomize(rng);
+    auto counting = std::make_unique<CountingMutation>(mut.get());
+    CountingMutation* cnt = counting.get();
+
+    auto t0 = std::chrono::steady_clock::now();
+    SimulatedAnnealing engine(std::move(init), std::move(counting), std::move(temp), sa);
+    engine.run();
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    r.iters = cnt->count;
+    return r;
+}
+
+bool bench_round(const Instance& I, const SAParams& sa, const ParParams& pp, bool pin,
+                 const std::function<std::unique_ptr<IMutation>()>& makeMut,
+                 const std::function<std::unique_ptr<ITempSchedule>()>& makeTemp, std::vector<WorkerRate>& out) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    std::vector<pid_t> kids;
+    for (uint32_t rank = 0; rank < pp.nproc; ++rank) {
+        pid_t pid = fork();
+        if (pid < 0) break;
+        if (pid == 0) {
+            close(fds[0]);
+            // мутация и расписание создаются заново в ребёнке и принадлежат только ему
+            WorkerRate r = run_worker(I, sa, rank, pin, pp.firstCore, makeMut(), makeTemp());
+            ssize_t w = write(fds[1], &r, sizeof(r));
+            _exit(w == sizeof(r) ? 0 : 1);
+        }
+        kids.push_back(pid);
+    }
+    close(fds[1]);
+    WorkerRate r;
+    while (read(fds[0], &r, sizeof(r)) == sizeof(r)) out.push_back(r);
+    close(fds[0]);
+    for (pid_t k : kids) waitpid(k, nullptr, 0);
+    std::sort(out.begin(), out.end(), [](const WorkerRate& a, const WorkerRate& b) { return a.rank < b.rank; });
+    return out.size() == kids.size() && kids.size() == pp.nproc;
+}
+
+void print_round(const char* title, const std::vector<WorkerRate>& rs) {
+    double total = 0;
+    std::printf("%s\n%6s %5s %5s %12s %10s %14s\n", title, "rank", "cpu", "node", "iters", "sec", "iters/sec");
+    for (const auto& r : rs) {
+        std::printf("%6u %5d %5d %12llu %10.3f %14.1f\n", r.rank, r.cpu, r.node,
+                    (unsigned long long)r.iters, r.seconds, r.itersPerSec());
+        total += r.itersPerSec();
+    }
+    std::printf("%6s %5s %5s %12s %10s %14.1f\n\n", "total", "", "", "", "", total);
+}
+} // namespace
+
+int cpu_count() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? int(n) : 1;
+}
+
+int worker_cpu(uint32_t rank, int firstCore) {
+    if (firstCore < 0) return -1;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return -1;
+    int n = CPU_COUNT(&allowed);
+    if (n == 0) return -1;
+    uint64_t k = (uint64_t(firstCore) + rank) % uint64_t(n);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &allowed) && k-- == 0) return cpu;
+    return -1;
+}
+
+int numa_node_of_cpu(int cpu) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4) return std::stoi(name.substr(4));
+    }
+    return -1;
+}
+
+bool pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool bind_to_node(const void* p, size_t n, int node) {
+    if (node < 0 || node >= int(8 * sizeof(unsigned long)) || n == 0) return false;
+    const uintptr_t page = uintptr_t(sysconf(_SC_PAGESIZE));
+    uintptr_t beg = uintptr_t(p) & ~(page - 1);
+    uintptr_t end = (uintptr_t(p) + n + page - 1) & ~(page - 1);
+    unsigned long mask = 1UL << node;
+    return syscall(SYS_mbind, beg, end - beg, kMpolBind, &mask, 8 * sizeof(mask), kMpolMfMove) == 0;
+}
+
+Instance replicate_instance(const Instance& I, int node) {
+    Instance R;
+    R.N = I.N; R.M = I.M;
+    // first-touch: страницы выделяются на узле ядра, на котором мы уже сидим
+    R.t.resize(I.t.size());
+    std::copy(I.t.begin(), I.t.end(), R.t.begin());
+    if (node >= 0) bind_to_node(R.t.data(), R.t.size() * sizeof(uint32_t), node);
+    return R;
+}
+
+int setup_worker_affinity(uint32_t rank, const ParParams& pp) {
+    if (!pp.pinWorkers) return -1;
+    int cpu = worker_cpu(rank, pp.firstCore);
+    return cpu >= 0 && pin_to_cpu(cpu) ? cpu : -1;
+}
+
+int bench_affinity(const Instance& I, SAParams sa, ParParams pp,
+                   const std::function<std::unique_ptr<IMutation>()>& makeMut,
+                   const std::function<std::unique_ptr<ITempSchedule>()>& makeTemp) {
+    if (pp.firstCore < 0) {
+        std::fprintf(stderr, "bench_affinity: firstCore must be >= 0 (got %d)\n", pp.firstCore);
+        return 1;
+    }
+    std::vector<WorkerRate> freeRun, pinnedRun;
+    if (!bench_round(I, sa, pp, false, makeMut, makeTemp, freeRun)) return 1;
+    if (!bench_round(I, sa, pp, true, makeMut, makeTemp, pinnedRun)) return 1;
+    print_round("== without pinning ==", freeRun);
+    print_round("== pinned + NUMA replica ==", pinnedRun);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "schedule.hpp"
+#include "sa.hpp"
+#include "parallel.hpp"
+#include <functional>
+#include <vector>
+
+// Привязка воркеров run_parallel к ядрам и NUMA-узлам.
+// Воркер с номером rank садится на (firstCore + rank)-й по кругу CPU из разрешённых
+// процессу (sched_getaffinity: cpuset, taskset), а не из всех ядер машины,
+// после чего копирует Instance::t к себе: по first-touch страницы
+// оказываются на локальном узле, а mbind(MPOL_BIND|MF_MOVE) дотягивает остальное.
+
+int cpu_count();
+int worker_cpu(uint32_t rank, int firstCore);      // -1, если firstCore < 0 или маска пуста
+int numa_node_of_cpu(int cpu);                     // -1, если NUMA нет
+bool pin_to_cpu(int cpu);                          // sched_setaffinity на текущий процесс
+bool bind_to_node(const void* p, size_t n, int node); // mbind диапазона страниц
+
+// Локальная для узла копия инстанса (реплика на каждый NUMA-узел)
+Instance replicate_instance(const Instance& I, int node);
+
+// Вызывается в воркере сразу после fork(); возвращает выбранное ядро или -1
+int setup_worker_affinity(uint32_t rank, const ParParams& pp);
+
+// Обёртка над мутацией, считающая итерации (одна apply == одна итерация ИО)
+struct CountingMutation : IMutation {
+    explicit CountingMutation(IMutation* inner) : inner_(inner) {}
+    void apply(ISolution& s, std::mt19937_64& rng) override { ++count; inner_->apply(s, rng); }
+    void feedback(double delta) override { inner_->feedback(delta); }
+    IMutation* inner_;
+    uint64_t count{0};
+};
+
+struct WorkerRate {
+    uint32_t rank{0};
+    int cpu{-1}, node{-1};
+    uint64_t iters{0};
+    double seconds{0.0};
+    double itersPerSec() const { return seconds > 0 ? iters / seconds : 0.0; }
+};
+
+// Замер: pp.nproc воркеров без привязки, затем с привязкой; печать таблицы it/s.
+// Фабрики зовутся в каждом форкнутом воркере: у него свои мутация и расписание.
+int bench_affinity(const Instance& I, SAParams sa, ParParams pp,
+                   const std::function<std::unique_ptr<IMutation>()>& makeMut,
+                   const std::function<std::unique_ptr<ITempSchedule>()>& makeTemp);
@@ -0,0 +1,162 @@
+#include "batched.hpp"
+#include "mutations.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <typeinfo>
+
+namespace {
+constexpr int64_t kInvalid = std::numeric_limits<int64_t>::max() / 4; // ход из пустого Gj
+} // namespace
+
+BatchedAnnealer::BatchedAnnealer(std::unique_ptr<ScheduleSolution> init,
+                                 std::unique_ptr<ITempSchedule> temp,
+                                 SAParams p,
+                                 BatchMoves moves)
+    : cur_(std::move(init)), temp_(std::move(temp)), P_(p), moves_(moves), rng_(p.seed) {
+    P_.batchK = std::max<size_t>(P_.batchK, 1);
+    pre_.resize(cur_->G.size());
+    for (uint32_t j = 0; j < cur_->G.size(); ++j) rebuild_prefix(j);
+    swap_.resize(P_.batchK); a_.resize(P_.batchK); b_.resize(P_.batchK);
+    x_.resize(P_.batchK); y_.resize(P_.batchK); d_.resize(P_.batchK); w_.resize(P_.batchK);
+}
+
+void BatchedAnnealer::rebuild_prefix(uint32_t j) {
+    const auto& Gj = cur_->G[j];
+    auto& p = pre_[j];
+    p.resize(Gj.size() + 1);
+    p[0] = 0;
+    for (size_t k = 0; k < Gj.size(); ++k) p[k + 1] = p[k] + cur_->inst_->t[Gj[k]];
+}
+
+void BatchedAnnealer::generate(size_t K) {
+    const uint32_t M = uint32_t(cur_->G.size());
+    for (size_t k = 0; k < K; ++k) {
+        uint64_t r = rng_();
+        uint32_t a = uint32_t(r % M);
+        uint32_t na = uint32_t(cur_->G[a].size());
+        // при обоих видах — монетка; перенос невозможен при M < 2, обмен бессмыслен при na < 2
+        bool swap = !moves_.move || (moves_.swap && ((r >> 32) & 1) && na >= 2);
+        a_[k] = a;
+        if (swap || M < 2) {
+            uint32_t x = uint32_t(rng_() % std::max(na, 1u)), y = uint32_t(rng_() % std::max(na, 1u));
+            if (!moves_.swap) y = x; // только переносы, а переносить некуда: пустой ход
+            swap_[k] = 1;
+            b_[k] = a;
+            x_[k] = std::min(x, y);
+            y_[k] = std::max(x, y);
+        } else {
+            uint32_t b = (a + 1 + uint32_t(rng_() % (M - 1))) % M;
+            b_[k] = b;
+            x_[k] = na ? uint32_t(rng_() % na) : 0;
+            y_[k] = uint32_t(rng_() % (cur_->G[b].size() + 1));
+        }
+    }
+}
+
+// ΔK2, O(1) на кандидата:
+//  обмен x<y в Gj:  (t_y - t_x) * (y - x);
+//  перенос a[x] -> b[y]: -(C_x + t*(n_a-1-x)) + (pre_b[y] + t + t*(n_b-y))
+void BatchedAnnealer::evaluate(size_t K) {
+    for (size_t k = 0; k < K; ++k) {
+        const auto& pa = pre_[a_[k]];
+        const auto& pb = pre_[b_[k]];
+        const int64_t na = int64_t(pa.size()) - 1, nb = int64_t(pb.size()) - 1;
+        const int64_t x = x_[k], y = y_[k];
+        if (na == 0) { d_[k] = kInvalid; continue; }
+        const int64_t tx = int64_t(pa[x + 1] - pa[x]);
+        if (swap_[k]) {
+            const int64_t ty = int64_t(pa[y + 1] - pa[y]);
+            d_[k] = (ty - tx) * (y - x);
+        } else {
+            d_[k] = -(int64_t(pa[x + 1]) + tx * (na - 1 - x)) + (int64_t(pb[y]) + tx + tx * (nb - y));
+        }
+    }
+}
+
+void BatchedAnnealer::apply(size_t k) {
+    auto& G = cur_->G;
+    if (swap_[k]) {
+        std::swap(G[a_[k]][x_[k]], G[a_[k]][y_[k]]);
+        rebuild_prefix(a_[k]);
+        return;
+    }
+    uint32_t job = G[a_[k]][x_[k]];
+    G[a_[k]].erase(G[a_[k]].begin() + x_[k]);
+    G[b_[k]].insert(G[b_[k]].begin() + y_[k], job);
+    rebuild_prefix(a_[k]);
+    rebuild_prefix(b_[k]);
+}
+
+std::unique_ptr<ISolution> BatchedAnnealer::run() {
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    const size_t K = P_.batchK;
+    int64_t curK2 = int64_t(evalK2(*cur_)), bestK2 = curK2;
+    curIsBest_ = true;
+    size_t noImprove = 0;
+    temp_->reset(P_.T0);
+
+    while (temp_->current() > P_.Tmin && noImprove < P_.patienceK) {
+        const double T = temp_->current();
+        bool improved = false;
+        for (size_t step = 0; step < P_.itersPerT; ++step) {
+            generate(K);
+            evaluate(K);
+            stats_.iters += K; // кандидаты, не шаги
+
+            size_t pick = K;
+            if (P_.rejectionFree) {
+                double W = 0;
+                for (size_t k = 0; k < K; ++k) {
+                    w_[k] = d_[k] == kInvalid ? 0.0 : std::exp(std::min(0.0, -double(d_[k]) / T));
+                    W += w_[k];
+                }
+                if (W <= 0) continue;
+                double r = U(rng_) * W;
+                for (pick = 0; pick + 1 < K && r >= w_[pick]; ++pick) r -= w_[pick];
+            } else {
+                for (size_t k = 0; k < K && pick == K; ++k)
+                    if (d_[k] <= 0 || U(rng_) < std::exp(-double(d_[k]) / T)) pick = k;
+            }
+            if (pick == K) continue;
+
+            // копируем лучшее только перед тем, как уйти с него вверх, а не на каждом улучшении
+            if (curIsBest_ && d_[pick] > 0) {
+                bestG_ = cur_->G;
+                curIsBest_ = false;
+            }
+            apply(pick);
+            curK2 += d_[pick];
+            ++stats_.accepted;
+            if (curK2 < bestK2) {
+                bestK2 = curK2;
+                curIsBest_ = true;
+                improved = true;
+            }
+        }
+        if (P_.target >= 0 && double(bestK2) <= P_.target) break;
+        noImprove = improved ? 0 : noImprove + 1;
+        temp_->next();
+    }
+
+    auto best = std::make_unique<ScheduleSolution>(cur_->inst_);
+    best->G = curIsBest_ ? cur_->G : bestG_;
+    best->rebuildHFromOrders();
+    return best;
+}
+
+std::unique_ptr<ISearchEngine> make_batched(std::unique_ptr<ISolution>& init,
+                                            const IMutation* mut,
+                                            std::unique_ptr<ITempSchedule>& temp,
+                                            const SAParams& p) {
+    if (!init || typeid(*init) != typeid(ScheduleSolution)) return nullptr;
+    if (p.objective != ObjectiveKind::K2 || p.restart != RestartPolicy::None) return nullptr;
+    BatchMoves moves;
+    if (mut) {
+        if (typeid(*mut) == typeid(SwapInProc)) moves.move = false;
+        else if (typeid(*mut) == typeid(MoveBetweenProcs)) moves.swap = false;
+        else return nullptr;
+    }
+    auto* S = static_cast<ScheduleSolution*>(init.release());
+    return std::make_unique<BatchedAnnealer>(std::unique_ptr<ScheduleSolution>(S), std::move(temp), p, moves);
+}
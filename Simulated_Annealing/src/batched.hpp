@@ -0,0 +1,55 @@
+#pragma once
+#include "schedule.hpp"
+
+// ИО с пакетной оценкой: за шаг строится batchK кандидатов от текущего ScheduleSolution
+// (перенос работы между процессорами или обмен внутри процессора) и ΔK2 всех считается
+// одним циклом по SoA-массивам кандидатов за O(1) каждый — по префиксным суммам процессоров.
+// Принимается не больше одного:
+//   Метрополис     — первый кандидат, прошедший тест (как batchK обычных шагов без лишних clone);
+//   rejectionFree  — n-fold way: кандидат i с вероятностью min(1, e^{-Δi/T}) / sum, всегда.
+// При низкой T почти всё отвергается, и вместо сотен пустых шагов делается один полезный.
+// stats().iters, как у остальных движков, — число оценённых кандидатов (batchK на шаг), accepted — принятых.
+// Какие ходы строить, задаёт BatchMoves: оба вида (мутация не задана), только обмены (SwapInProc)
+// или только переносы (MoveBetweenProcs).
+struct BatchMoves {
+    bool swap{true}, move{true};
+};
+
+class BatchedAnnealer : public ISearchEngine {
+public:
+    BatchedAnnealer(std::unique_ptr<ScheduleSolution> init,
+                    std::unique_ptr<ITempSchedule> temp,
+                    SAParams p,
+                    BatchMoves moves = {});
+    std::unique_ptr<ISolution> run() override;
+
+private:
+    void rebuild_prefix(uint32_t j);
+    void generate(size_t K);
+    void evaluate(size_t K);
+    void apply(size_t k);
+
+    std::unique_ptr<ScheduleSolution> cur_;
+    std::vector<std::deque<uint32_t>> bestG_; // снимок лучшего; пока curIsBest_, лучшее — сам cur_
+    bool curIsBest_{true};
+    std::unique_ptr<ITempSchedule> temp_;
+    SAParams P_;
+    BatchMoves moves_;
+    std::mt19937_64 rng_;
+    std::vector<std::vector<uint64_t>> pre_; // pre_[j][k] = сумма t первых k работ Gj
+
+    // кандидаты, structure-of-arrays
+    std::vector<uint8_t> swap_;  // 0 — перенос a[x] -> b[y], 1 — обмен a[x] <-> a[y]
+    std::vector<uint32_t> a_, b_, x_, y_;
+    std::vector<int64_t> d_;
+    std::vector<double> w_;
+};
+
+// Для make_engine: nullptr (init и temp не тронуты), если пакетный шаг не равносилен заказанному —
+// init не ровно ScheduleSolution (у наследников свой objective), objective не К2, задана политика
+// рестартов или мутация mut не из тех, что BatchedAnnealer делает сам (SwapInProc, MoveBetweenProcs).
+// mut == nullptr — оба вида ходов, SwapInProc/MoveBetweenProcs — только свой вид
+std::unique_ptr<ISearchEngine> make_batched(std::unique_ptr<ISolution>& init,
+                                            const IMutation* mut,
+                                            std::unique_ptr<ITempSchedule>& temp,
+                                            const SAParams& p);
@@ -0,0 +1,164 @@
+#include "buckets.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+DurationClasses DurationClasses::build(const Instance& I) {
+    DurationClasses dc;
+    std::map<uint32_t, uint32_t> ids;
+    for (uint32_t t : I.t) ids.emplace(t, 0);
+    for (auto& [t, id] : ids) { id = uint32_t(dc.value.size()); dc.value.push_back(t); }
+    dc.jobs.resize(dc.value.size());
+    dc.classOf.resize(I.N);
+    for (uint32_t i = 0; i < I.N; ++i) {
+        uint32_t c = ids[I.t[i]];
+        dc.classOf[i] = c;
+        dc.jobs[c].push_back(i);
+    }
+    return dc;
+}
+
+ClassCountSolution::ClassCountSolution(const Instance* inst, const DurationClasses* dc)
+    : inst_(inst), dc_(dc) {
+    cnt.assign(size_t(inst_->M) * dc_->size(), 0);
+    load.assign(inst_->M, 0);
+    pk2_.assign(inst_->M, 0);
+}
+
+// SPT: k работ длительности v после уже набранной нагрузки L дают k*L + v*k(k+1)/2
+uint64_t ClassCountSolution::procK2(uint32_t p) const {
+    const uint32_t D = dc_->size();
+    const uint32_t* row = cnt.data() + size_t(p) * D;
+    uint64_t L = 0, sum = 0;
+    for (uint32_t c = 0; c < D; ++c) {
+        uint64_t k = row[c], v = dc_->value[c];
+        sum += k * L + v * k * (k + 1) / 2;
+        L += k * v;
+    }
+    return sum;
+}
+
+void ClassCountSolution::recompute() {
+    k2_ = 0;
+    for (uint32_t p = 0; p < inst_->M; ++p) {
+        pk2_[p] = procK2(p);
+        k2_ += pk2_[p];
+    }
+}
+
+void ClassCountSolution::move(uint32_t c, uint32_t p, uint32_t q, uint32_t n) {
+    const uint32_t D = dc_->size();
+    cnt[size_t(p) * D + c] -= n;
+    cnt[size_t(q) * D + c] += n;
+    load[p] -= n;
+    load[q] += n;
+    k2_ -= pk2_[p] + pk2_[q];
+    pk2_[p] = procK2(p);
+    pk2_[q] = procK2(q);
+    k2_ += pk2_[p] + pk2_[q];
+}
+
+uint32_t ClassCountSolution::randomClassOn(uint32_t p, std::mt19937_64& rng) const {
+    const uint32_t D = dc_->size();
+    uint32_t r = uint32_t(rng() % load[p]);
+    const uint32_t* row = cnt.data() + size_t(p) * D;
+    uint32_t c = 0;
+    while (r >= row[c]) r -= row[c++];
+    return c;
+}
+
+std::unique_ptr<ISolution> ClassCountSolution::clone() const {
+    return std::make_unique<ClassCountSolution>(*this);
+}
+
+void ClassCountSolution::randomize(std::mt19937_64& rng) {
+    std::fill(cnt.begin(), cnt.end(), 0);
+    std::fill(load.begin(), load.end(), 0);
+    const uint32_t D = dc_->size();
+    for (uint32_t i = 0; i < inst_->N; ++i) {
+        uint32_t p = uint32_t(rng() % inst_->M);
+        ++cnt[size_t(p) * D + dc_->classOf[i]];
+        ++load[p];
+    }
+    recompute();
+}
+
+void ClassCountSolution::serialize(std::vector<uint8_t>& out) const {
+    out.resize(cnt.size() * sizeof(uint32_t));
+    std::memcpy(out.data(), cnt.data(), out.size());
+}
+
+bool ClassCountSolution::deserialize(const uint8_t* p, size_t n) {
+    if (n != cnt.size() * sizeof(uint32_t)) return false;
+    const uint32_t D = dc_->size();
+    // по процессорам каждый класс должен раскладываться ровно целиком, иначе expand() выйдет за jobs[c]
+    std::vector<uint32_t> in(cnt.size());
+    std::memcpy(in.data(), p, n);
+    for (uint32_t c = 0; c < D; ++c) {
+        uint64_t total = 0;
+        for (uint32_t q = 0; q < inst_->M; ++q) total += in[size_t(q) * D + c];
+        if (total != dc_->jobs[c].size()) return false;
+    }
+    cnt.swap(in);
+    for (uint32_t q = 0; q < inst_->M; ++q) {
+        load[q] = 0;
+        for (uint32_t c = 0; c < D; ++c) load[q] += cnt[size_t(q) * D + c];
+    }
+    recompute();
+    return true;
+}
+
+ScheduleSolution ClassCountSolution::expand() const {
+    ScheduleSolution S(inst_);
+    const uint32_t D = dc_->size();
+    std::vector<uint32_t> next(D, 0); // сколько работ класса уже роздано
+    for (uint32_t p = 0; p < inst_->M; ++p)
+        for (uint32_t c = 0; c < D; ++c)
+            for (uint32_t k = 0; k < count(p, c); ++k) S.G[p].push_back(dc_->jobs[c][next[c]++]);
+    S.rebuildHFromOrders();
+    return S;
+}
+
+void ClassCountSolution::assignFrom(const ScheduleSolution& S) {
+    std::fill(cnt.begin(), cnt.end(), 0);
+    std::fill(load.begin(), load.end(), 0);
+    const uint32_t D = dc_->size();
+    for (uint32_t p = 0; p < S.G.size(); ++p)
+        for (uint32_t i : S.G[p]) {
+            ++cnt[size_t(p) * D + dc_->classOf[i]];
+            ++load[p];
+        }
+    recompute();
+}
+
+namespace {
+bool pick_two(const ClassCountSolution& S, uint32_t& p, uint32_t& q, std::mt19937_64& rng) {
+    const uint32_t M = S.inst_->M;
+    if (M < 2) return false;
+    p = uint32_t(rng() % M);
+    for (uint32_t k = 0; k < M && S.jobsOn(p) == 0; ++k) p = (p + 1) % M;
+    if (S.jobsOn(p) == 0) return false;
+    q = (p + 1 + uint32_t(rng() % (M - 1))) % M;
+    return true;
+}
+} // namespace
+
+void MoveClassUnit::apply(ISolution& s, std::mt19937_64& rng) {
+    auto& S = static_cast<ClassCountSolution&>(s);
+    uint32_t p, q;
+    if (!pick_two(S, p, q, rng)) return;
+    S.move(S.randomClassOn(p, rng), p, q);
+}
+
+void SwapClassUnits::apply(ISolution& s, std::mt19937_64& rng) {
+    auto& S = static_cast<ClassCountSolution&>(s);
+    uint32_t p, q;
+    if (!pick_two(S, p, q, rng) || S.jobsOn(q) == 0) return;
+    uint32_t a = S.randomClassOn(p, rng), b = S.randomClassOn(q, rng);
+    // одинаковые классы: ищем на q любой другой класс, иначе обмен бессмыслен
+    for (uint32_t c = 0; a == b && c < S.dc_->size(); ++c)
+        if (c != a && S.count(q, c) > 0) b = c;
+    if (a == b) return;
+    S.move(a, p, q);
+    S.move(b, q, p);
+}
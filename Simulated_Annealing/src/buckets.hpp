@@ -0,0 +1,56 @@
+#pragma once
+#include "schedule.hpp"
+
+// Работы одинаковой длительности неразличимы: обмен двух таких работ — пустой ход.
+// Предобработка группирует работы по длительности в классы, а решение хранит только
+// число работ каждого класса на каждом процессоре (порядок на процессоре — SPT).
+// Пространство поиска и цена хода сжимаются с N до D = числа различных длительностей.
+struct DurationClasses {
+    std::vector<uint32_t> value;             // длительность класса, по возрастанию
+    std::vector<uint32_t> classOf;           // работа -> класс
+    std::vector<std::vector<uint32_t>> jobs; // класс -> работы
+
+    static DurationClasses build(const Instance& I);
+    uint32_t size() const { return uint32_t(value.size()); }
+};
+
+struct ClassCountSolution : ISolution {
+    ClassCountSolution(const Instance* inst, const DurationClasses* dc);
+
+    uint32_t count(uint32_t p, uint32_t c) const { return cnt[size_t(p) * dc_->size() + c]; }
+    uint32_t jobsOn(uint32_t p) const { return load[p]; }
+    // Перенос n работ класса c с процессора p на q, К2 пересчитывается по двум процессорам за O(D)
+    void move(uint32_t c, uint32_t p, uint32_t q, uint32_t n = 1);
+    uint32_t randomClassOn(uint32_t p, std::mt19937_64& rng) const; // класс случайной работы на p
+
+    // ISolution
+    double objective() const override { return double(k2_); }
+    std::unique_ptr<ISolution> clone() const override;
+    void randomize(std::mt19937_64& rng) override;
+    void serialize(std::vector<uint8_t>& out) const override;
+    bool deserialize(const uint8_t* p, size_t n) override;
+
+    // Обратно в полное расписание (Gj в SPT-порядке, H пересобрана) и из него
+    ScheduleSolution expand() const;
+    void assignFrom(const ScheduleSolution& S);
+
+    std::vector<uint32_t> cnt;  // [p * D + c]
+    std::vector<uint32_t> load; // число работ на процессоре
+    const Instance* inst_{nullptr};
+    const DurationClasses* dc_{nullptr};
+
+private:
+    uint64_t procK2(uint32_t p) const;
+    void recompute();
+    std::vector<uint64_t> pk2_;
+    uint64_t k2_{0};
+};
+
+// Ходы никогда не трогают пару работ одной длительности
+struct MoveClassUnit : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override; // работа класса c: G_a -> G_b
+};
+
+struct SwapClassUnits : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override; // обмен работ разных классов между G_a и G_b
+};
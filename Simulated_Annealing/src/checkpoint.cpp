@@ -0,0 +1,174 @@
+#include "checkpoint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+constexpr char kMagic[4] = {'S', 'A', 'C', 'K'};
+constexpr uint32_t kVersion = 1;
+
+struct Out {
+    std::vector<uint8_t> buf;
+    template <class T> void pod(const T& v) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+        buf.insert(buf.end(), p, p + sizeof(T));
+    }
+    void blob(const void* p, uint64_t n) {
+        pod(n);
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        buf.insert(buf.end(), b, b + n);
+    }
+};
+
+struct In {
+    const uint8_t* p;
+    const uint8_t* end;
+    template <class T> bool pod(T& v) {
+        if (size_t(end - p) < sizeof(T)) return false;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+    template <class C> bool blob(C& out) {
+        uint64_t n;
+        if (!pod(n) || uint64_t(end - p) < n) return false;
+        out.assign(p, p + n);
+        p += n;
+        return true;
+    }
+};
+
+uint64_t checksum(const uint8_t* p, size_t n) { // FNV-1a
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+    return h;
+}
+} // namespace
+
+bool save_checkpoint(const std::string& path, const WorkerCheckpoint& c) {
+    Out o;
+    o.buf.insert(o.buf.end(), kMagic, kMagic + 4);
+    o.pod(kVersion);
+    o.pod(c.rank); o.pod(c.T); o.pod(c.level); o.pod(c.iters); o.pod(c.noImprove);
+    o.blob(c.rngState.data(), c.rngState.size());
+    o.blob(c.cur.data(), c.cur.size());
+    o.blob(c.best.data(), c.best.size());
+    o.pod(c.curObj); o.pod(c.bestObj);
+    o.blob(c.globalBest.data(), c.globalBest.size());
+    o.pod(c.globalBestObj); o.pod(c.outerNoImprove);
+    o.pod(checksum(o.buf.data(), o.buf.size()));
+
+    const std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    size_t off = 0;
+    while (off < o.buf.size()) {
+        ssize_t w = ::write(fd, o.buf.data() + off, o.buf.size() - off);
+        if (w <= 0) { ::close(fd); ::unlink(tmp.c_str()); return false; }
+        off += size_t(w);
+    }
+    bool ok = ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) { ::unlink(tmp.c_str()); return false; }
+    // rename живёт в записи каталога: без fsync каталога после сбоя может остаться старый файл
+    const size_t slash = path.find_last_of('/');
+    const std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dfd < 0) return false;
+    ok = ::fsync(dfd) == 0;
+    ::close(dfd);
+    return ok;
+}
+
+bool load_checkpoint(const std::string& path, WorkerCheckpoint& c) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<uint8_t> buf;
+    uint8_t chunk[1 << 16];
+    for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0;) buf.insert(buf.end(), chunk, chunk + n);
+    std::fclose(f);
+    if (buf.size() < 4 + sizeof(uint32_t) + sizeof(uint64_t) || std::memcmp(buf.data(), kMagic, 4) != 0) return false;
+
+    const size_t body = buf.size() - sizeof(uint64_t);
+    uint64_t sum;
+    std::memcpy(&sum, buf.data() + body, sizeof(sum));
+    if (sum != checksum(buf.data(), body)) return false;
+
+    In in{buf.data() + 4, buf.data() + body};
+    uint32_t ver;
+    return in.pod(ver) && ver == kVersion &&
+           in.pod(c.rank) && in.pod(c.T) && in.pod(c.level) && in.pod(c.iters) && in.pod(c.noImprove) &&
+           in.blob(c.rngState) && in.blob(c.cur) && in.blob(c.best) && in.pod(c.curObj) && in.pod(c.bestObj) &&
+           in.blob(c.globalBest) && in.pod(c.globalBestObj) && in.pod(c.outerNoImprove) && in.p == in.end;
+}
+
+std::string checkpoint_path(const std::string& dir, uint32_t rank) {
+    return dir + (rank == UINT32_MAX ? "/master.ck" : "/worker_" + std::to_string(rank) + ".ck");
+}
+
+void capture(WorkerCheckpoint& c, const ISolution& cur, const ISolution& best, const std::mt19937_64& rng) {
+    cur.serialize(c.cur);
+    best.serialize(c.best);
+    c.curObj = cur.objective();
+    c.bestObj = best.objective();
+    std::ostringstream ss;
+    ss << rng;
+    c.rngState = ss.str();
+}
+
+bool restore(const WorkerCheckpoint& c, ISolution& cur, ISolution& best, std::mt19937_64& rng) {
+    if (!cur.deserialize(c.cur.data(), c.cur.size()) || !best.deserialize(c.best.data(), c.best.size())) return false;
+    std::istringstream ss(c.rngState);
+    ss >> rng;
+    return !ss.fail();
+}
+
+CheckpointWriter::CheckpointWriter(std::string path, double everySec)
+    : path_(std::move(path)), everySec_(everySec), last_(std::chrono::steady_clock::now()),
+      th_([this] { loop(); }) {}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    th_.join();
+}
+
+bool CheckpointWriter::due() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - last_).count() >= everySec_;
+}
+
+void CheckpointWriter::submit(WorkerCheckpoint c) {
+    last_ = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        pending_ = std::move(c);
+    }
+    cv_.notify_one();
+}
+
+uint64_t CheckpointWriter::written() const {
+    std::lock_guard<std::mutex> lk(mu_);
+    return written_;
+}
+
+void CheckpointWriter::loop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    while (true) {
+        cv_.wait(lk, [this] { return stop_ || pending_; });
+        if (pending_) {
+            WorkerCheckpoint c = std::move(*pending_);
+            pending_.reset();
+            lk.unlock();
+            bool ok = save_checkpoint(path_, c);
+            lk.lock();
+            if (ok) ++written_;
+        } else if (stop_) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "sa.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Снимки долгих прогонов run_parallel, чтобы после вытеснения продолжить, а не начинать с randomize.
+// Файл: "SACK" | версия | поля | FNV-1a всего файла; пишется в <path>.tmp, fsync, rename — атомарно.
+struct WorkerCheckpoint {
+    uint32_t rank{0};
+    double T{0.0};
+    uint64_t level{0}, iters{0}, noImprove{0};
+    std::string rngState;               // operator<< для std::mt19937_64
+    std::vector<uint8_t> cur, best;     // ISolution::serialize
+    double curObj{0.0}, bestObj{0.0};
+    std::vector<uint8_t> globalBest;    // последний globalBest от мастера (для мастера — свой)
+    double globalBestObj{0.0};
+    uint64_t outerNoImprove{0};         // только мастер
+};
+
+bool save_checkpoint(const std::string& path, const WorkerCheckpoint& c);
+bool load_checkpoint(const std::string& path, WorkerCheckpoint& c);
+std::string checkpoint_path(const std::string& dir, uint32_t rank); // rank == UINT32_MAX -> мастер
+
+// Снимок состояния в горячем цикле: только serialize в буферы, без ввода-вывода
+void capture(WorkerCheckpoint& c, const ISolution& cur, const ISolution& best, const std::mt19937_64& rng);
+// Восстановление вместо randomize; false — снимок не подходит к решению
+bool restore(const WorkerCheckpoint& c, ISolution& cur, ISolution& best, std::mt19937_64& rng);
+
+// Фоновый писатель: submit() кладёт снимок в ячейку (старый, не записанный, вытесняется)
+// и сразу возвращается; запись на диск идёт в отдельном потоке.
+class CheckpointWriter {
+public:
+    CheckpointWriter(std::string path, double everySec);
+    ~CheckpointWriter(); // дописывает последний снимок
+    bool due() const;    // пора снимать (прошло everySec с прошлого submit)
+    void submit(WorkerCheckpoint c);
+    uint64_t written() const;
+
+private:
+    void loop();
+    std::string path_;
+    double everySec_;
+    std::chrono::steady_clock::time_point last_;
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::optional<WorkerCheckpoint> pending_;
+    bool stop_{false};
+    uint64_t written_{0};
+    std::thread th_;
+};
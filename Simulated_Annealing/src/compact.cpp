@@ -0,0 +1,26 @@
+#include "compact.hpp"
+#include <limits>
+
+bool choose_widths(const Instance& I, CompactWidths& w) {
+    uint64_t sumT = 0, maxT = 0;
+    for (uint32_t t : I.t) {
+        sumT += t;
+        maxT = std::max<uint64_t>(maxT, t);
+    }
+    // все работы на одном процессоре: К2 <= N * sum(t)
+    uint64_t bound;
+    if (__builtin_mul_overflow(uint64_t(I.N), sumT, &bound)) return false;
+    // индекс хранит и номер работы (< N), и длину Gj (<= N)
+    w.idxBytes = I.N <= std::numeric_limits<uint16_t>::max() ? 2 : 4;
+    w.durBytes = maxT <= std::numeric_limits<uint16_t>::max() ? 2 : 4;
+    return true;
+}
+
+std::unique_ptr<ICompactModel> make_compact_model(const Instance& I) {
+    CompactWidths w;
+    if (!choose_widths(I, w)) return nullptr;
+    if (w.idxBytes == 2 && w.durBytes == 2) return std::make_unique<CompactModel<uint16_t, uint16_t>>(I);
+    if (w.idxBytes == 2) return std::make_unique<CompactModel<uint16_t, uint32_t>>(I);
+    if (w.durBytes == 2) return std::make_unique<CompactModel<uint32_t, uint16_t>>(I);
+    return std::make_unique<CompactModel<uint32_t, uint32_t>>(I);
+}
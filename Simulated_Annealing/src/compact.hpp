@@ -0,0 +1,136 @@
+#pragma once
+#include "schedule.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+// Узкие типы индексов и длительностей (uint16_t, где влезает), выбираются при загрузке.
+// Instance/ScheduleSolution остаются как есть (uint32_t); компактная модель живёт рядом
+// и переводится обратно через widen(). К2 всегда копится в uint64_t, а make_compact_model
+// заранее проверяет, что N * sum(t) (верхняя граница К2) в него помещается.
+template <class Dur>
+struct BasicInstance {
+    uint32_t N{0}, M{0};
+    std::vector<Dur> t; // size=N
+};
+
+template <class Idx, class Dur>
+struct CompactSchedule : ISolution {
+    static_assert(std::is_unsigned_v<Idx> && std::is_unsigned_v<Dur>);
+
+    explicit CompactSchedule(const BasicInstance<Dur>* inst) : inst_(inst) { G.resize(inst_->M); }
+
+    // Порядки работ на процессорах; без матрицы H
+    std::vector<std::vector<Idx>> G;
+
+    double objective() const override {
+        uint64_t sum = 0;
+        for (const auto& Gj : G) {
+            uint64_t acc = 0;
+            for (Idx i : Gj) { acc += inst_->t[i]; sum += acc; }
+        }
+        return double(sum);
+    }
+    std::unique_ptr<ISolution> clone() const override { return std::make_unique<CompactSchedule>(*this); }
+    void randomize(std::mt19937_64& rng) override {
+        for (auto& Gj : G) Gj.clear();
+        for (uint32_t i = 0; i < inst_->N; ++i) G[rng() % inst_->M].push_back(Idx(i));
+    }
+    // [len_0 .. len_{M-1}][индексы] — всё шириной Idx
+    void serialize(std::vector<uint8_t>& out) const override {
+        out.resize(sizeof(Idx) * (G.size() + inst_->N));
+        uint8_t* p = out.data();
+        for (const auto& Gj : G) { Idx n = Idx(Gj.size()); std::memcpy(p, &n, sizeof(Idx)); p += sizeof(Idx); }
+        for (const auto& Gj : G) { std::memcpy(p, Gj.data(), Gj.size() * sizeof(Idx)); p += Gj.size() * sizeof(Idx); }
+    }
+    bool deserialize(const uint8_t* p, size_t n) override {
+        if (n != sizeof(Idx) * (G.size() + inst_->N)) return false;
+        // собираем во временные порядки: принимаем только перестановку 0..N-1, иначе G не трогаем
+        const uint8_t* q = p + sizeof(Idx) * G.size();
+        std::vector<std::vector<Idx>> in(G.size());
+        std::vector<uint8_t> seen(inst_->N, 0);
+        size_t total = 0;
+        for (auto& Gj : in) {
+            Idx len;
+            std::memcpy(&len, p, sizeof(Idx));
+            p += sizeof(Idx);
+            total += len;
+            if (total > inst_->N) return false;
+            Gj.resize(len);
+            std::memcpy(Gj.data(), q, len * sizeof(Idx));
+            q += len * sizeof(Idx);
+            for (Idx i : Gj) {
+                if (i >= inst_->N || seen[i]) return false;
+                seen[i] = 1;
+            }
+        }
+        if (total != inst_->N) return false;
+        G.swap(in);
+        return true;
+    }
+
+    const BasicInstance<Dur>* inst_{nullptr};
+};
+
+template <class Idx, class Dur>
+struct CompactSwapInProc : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override {
+        auto& S = static_cast<CompactSchedule<Idx, Dur>&>(s);
+        auto& Gj = S.G[rng() % S.G.size()];
+        if (Gj.size() < 2) return;
+        std::swap(Gj[rng() % Gj.size()], Gj[rng() % Gj.size()]);
+    }
+};
+
+template <class Idx, class Dur>
+struct CompactMoveBetweenProcs : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override {
+        auto& S = static_cast<CompactSchedule<Idx, Dur>&>(s);
+        if (S.G.size() < 2) return;
+        size_t a = rng() % S.G.size(), b = (a + 1 + rng() % (S.G.size() - 1)) % S.G.size();
+        if (S.G[a].empty()) return;
+        size_t k = rng() % S.G[a].size();
+        Idx job = S.G[a][k];
+        S.G[a].erase(S.G[a].begin() + k);
+        S.G[b].insert(S.G[b].begin() + rng() % (S.G[b].size() + 1), job);
+    }
+};
+
+struct CompactWidths {
+    uint8_t idxBytes{4}, durBytes{4};
+};
+
+// Компактная копия инстанса + фабрики решений и мутаций в выбранной ширине
+struct ICompactModel {
+    virtual ~ICompactModel() = default;
+    virtual CompactWidths widths() const = 0;
+    virtual std::unique_ptr<ISolution> make_solution() const = 0;
+    virtual std::unique_ptr<IMutation> make_swap() const = 0;
+    virtual std::unique_ptr<IMutation> make_move() const = 0;
+    virtual ScheduleSolution widen(const ISolution& s, const Instance& I) const = 0;
+};
+
+template <class Idx, class Dur>
+struct CompactModel : ICompactModel {
+    explicit CompactModel(const Instance& I) {
+        inst.N = I.N; inst.M = I.M;
+        inst.t.assign(I.t.begin(), I.t.end()); // ширина проверена в make_compact_model
+    }
+    CompactWidths widths() const override { return {uint8_t(sizeof(Idx)), uint8_t(sizeof(Dur))}; }
+    std::unique_ptr<ISolution> make_solution() const override { return std::make_unique<CompactSchedule<Idx, Dur>>(&inst); }
+    std::unique_ptr<IMutation> make_swap() const override { return std::make_unique<CompactSwapInProc<Idx, Dur>>(); }
+    std::unique_ptr<IMutation> make_move() const override { return std::make_unique<CompactMoveBetweenProcs<Idx, Dur>>(); }
+    ScheduleSolution widen(const ISolution& s, const Instance& I) const override {
+        const auto& C = static_cast<const CompactSchedule<Idx, Dur>&>(s);
+        ScheduleSolution S(&I);
+        for (size_t j = 0; j < C.G.size(); ++j) S.G[j].assign(C.G[j].begin(), C.G[j].end());
+        S.rebuildHFromOrders();
+        return S;
+    }
+    BasicInstance<Dur> inst;
+};
+
+// Подбор ширин по N, max t и границе К2; false, если К2 может переполнить uint64_t
+bool choose_widths(const Instance& I, CompactWidths& w);
+// Модель в ширинах choose_widths; nullptr в том же случае переполнения
+std::unique_ptr<ICompactModel> make_compact_model(const Instance& I);
@@ -0,0 +1,118 @@
+#include "engines.hpp"
+#include "restart.hpp"
+#include "batched.hpp"
+#include <chrono>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// true, если цель задана и достигнута (фиксирует время в stats)
+bool hit_target(const SAParams& P, double bestObj, EngineStats& st, Clock::time_point t0) {
+    if (P.target < 0 || bestObj > P.target) return false;
+    if (st.secToTarget < 0) st.secToTarget = since(t0);
+    return true;
+}
+} // namespace
+
+LateAcceptance::LateAcceptance(std::unique_ptr<ISolution> init,
+                               std::unique_ptr<IMutation> mut,
+                               std::unique_ptr<ITempSchedule>,
+                               SAParams p)
+    : cur_(std::move(init)), mut_(std::move(mut)), P_(p), rng_(p.seed) {
+    best_ = cur_->clone();
+}
+
+std::unique_ptr<ISolution> LateAcceptance::run() {
+    const auto t0 = Clock::now();
+    double curObj = cur_->objective(), bestObj = curObj;
+    std::vector<double> hist(std::max<size_t>(P_.lahcLength, 1), curObj);
+    // простой без улучшений в тех же единицах, что у ИО: patienceK уровней по itersPerT
+    const uint64_t idleLimit = uint64_t(P_.patienceK) * P_.itersPerT;
+    uint64_t idle = 0;
+
+    while (idle < idleLimit && !hit_target(P_, bestObj, stats_, t0)) {
+        auto cand = cur_->clone();
+        mut_->apply(*cand, rng_);
+        double candObj = cand->objective();
+        mut_->feedback(candObj - curObj);
+        double& h = hist[stats_.iters % hist.size()];
+        ++stats_.iters;
+        if (candObj <= curObj || candObj <= h) {
+            cur_ = std::move(cand);
+            curObj = candObj;
+            ++stats_.accepted;
+        }
+        h = curObj;
+        if (curObj < bestObj) {
+            best_ = cur_->clone();
+            bestObj = curObj;
+            idle = 0;
+        } else {
+            ++idle;
+        }
+    }
+    return best_->clone();
+}
+
+ThresholdAccepting::ThresholdAccepting(std::unique_ptr<ISolution> init,
+                                       std::unique_ptr<IMutation> mut,
+                                       std::unique_ptr<ITempSchedule> temp,
+                                       SAParams p)
+    : cur_(std::move(init)), mut_(std::move(mut)), temp_(std::move(temp)), P_(p), rng_(p.seed) {
+    best_ = cur_->clone();
+}
+
+std::unique_ptr<ISolution> ThresholdAccepting::run() {
+    const auto t0 = Clock::now();
+    double curObj = cur_->objective(), bestObj = curObj;
+    size_t noImprove = 0;
+    temp_->reset(P_.T0);
+
+    while (temp_->current() > P_.Tmin && noImprove < P_.patienceK && !hit_target(P_, bestObj, stats_, t0)) {
+        const double thr = temp_->current();
+        bool improved = false;
+        for (size_t k = 0; k < P_.itersPerT; ++k) {
+            auto cand = cur_->clone();
+            mut_->apply(*cand, rng_);
+            double candObj = cand->objective();
+            mut_->feedback(candObj - curObj);
+            ++stats_.iters;
+            if (candObj - curObj < thr) {
+                cur_ = std::move(cand);
+                curObj = candObj;
+                ++stats_.accepted;
+                if (curObj < bestObj) {
+                    best_ = cur_->clone();
+                    bestObj = curObj;
+                    improved = true;
+                }
+            }
+        }
+        noImprove = improved ? 0 : noImprove + 1;
+        temp_->next();
+    }
+    return best_->clone();
+}
+
+std::unique_ptr<ISearchEngine> make_engine(std::unique_ptr<ISolution> init,
+                                           std::unique_ptr<IMutation> mut,
+                                           std::unique_ptr<ITempSchedule> temp,
+                                           SAParams p) {
+    switch (p.engine) {
+    case EngineKind::LAHC:
+        return std::make_unique<LateAcceptance>(std::move(init), std::move(mut), std::move(temp), p);
+    case EngineKind::TA:
+        return std::make_unique<ThresholdAccepting>(std::move(init), std::move(mut), std::move(temp), p);
+    case EngineKind::SA:
+    default:
+        if (p.batchK > 1)
+            if (auto e = make_batched(init, mut.get(), temp, p)) return e;
+        if (p.restart != RestartPolicy::None)
+            return std::make_unique<RestartingAnnealer>(std::move(init), std::move(mut), std::move(temp), p);
+        return std::make_unique<SimulatedAnnealing>(std::move(init), std::move(mut), std::move(temp), p);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "sa.hpp"
+
+// Альтернативы Метрополису с тем же контрактом ISolution/IMutation.
+// LAHC: кандидат принимается, если не хуже текущего или значения lahcLength шагов назад.
+// TA:   кандидат принимается, если ухудшение < порога; порог ведёт ITempSchedule (T0 -> Tmin).
+class LateAcceptance : public ISearchEngine {
+public:
+    LateAcceptance(std::unique_ptr<ISolution> init,
+                   std::unique_ptr<IMutation> mut,
+                   std::unique_ptr<ITempSchedule> temp, // не используется, для единой сигнатуры
+                   SAParams p);
+    std::unique_ptr<ISolution> run() override;
+private:
+    std::unique_ptr<ISolution> cur_, best_;
+    std::unique_ptr<IMutation> mut_;
+    SAParams P_;
+    std::mt19937_64 rng_;
+};
+
+class ThresholdAccepting : public ISearchEngine {
+public:
+    ThresholdAccepting(std::unique_ptr<ISolution> init,
+                       std::unique_ptr<IMutation> mut,
+                       std::unique_ptr<ITempSchedule> temp,
+                       SAParams p);
+    std::unique_ptr<ISolution> run() override;
+private:
+    std::unique_ptr<ISolution> cur_, best_;
+    std::unique_ptr<IMutation> mut_;
+    std::unique_ptr<ITempSchedule> temp_;
+    SAParams P_;
+    std::mt19937_64 rng_;
+};
+
+// run_sequential/run_parallel создают движок по p.engine
+std::unique_ptr<ISearchEngine> make_engine(std::unique_ptr<ISolution> init,
+                                           std::unique_ptr<IMutation> mut,
+                                           std::unique_ptr<ITempSchedule> temp,
+                                           SAParams p);
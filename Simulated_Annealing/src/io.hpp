@@ -1,7 +1,42 @@
 #pragma once
 #include "schedule.hpp"
+#include <span>
 #include <string>
 
 bool load_instance_csv(const std::string& path, Instance& I);
 bool save_instance_csv(const std::string& path, const Instance& I);
-Instance generate_instance(uint32_t N, uint32_t M, uint32_t tmin, uint32_t tmax, uint64_t seed);
\ No newline at end of file
+Instance generate_instance(uint32_t N, uint32_t M, uint32_t tmin, uint32_t tmax, uint64_t seed);
+
+// Экспорт лучшего расписания без матрицы H: порядок работ по процессорам + времена завершения.
+// Пишется потоково, блоками по chunkBytes.
+// bin: [заголовок 32 B: "SASC", ver, N, M, K2, 0]
+//      [M записей {first, load, count, 0}: u64 u64 u32 u32]
+//      [C: u64 x N — времена завершения в порядке Gj][job: u32 x N]
+// csv: "# K2=..,N=..,M=.." затем строки proc,pos,job,t,completion
+bool write_schedule_bin(const std::string& path, const ScheduleSolution& S, size_t chunkBytes = 1 << 20);
+bool write_schedule_csv(const std::string& path, const ScheduleSolution& S, size_t chunkBytes = 1 << 20);
+
+// Чтение bin-файла через mmap, без копирования и пересборки H
+class ScheduleFileView {
+public:
+    ScheduleFileView() = default;
+    ScheduleFileView(const ScheduleFileView&) = delete;
+    ScheduleFileView& operator=(const ScheduleFileView&) = delete;
+    ~ScheduleFileView() { close(); }
+
+    bool open(const std::string& path);
+    void close();
+
+    uint32_t N() const { return N_; }
+    uint32_t M() const { return M_; }
+    uint64_t K2() const { return K2_; }
+    uint64_t load(uint32_t p) const;
+    std::span<const uint32_t> jobs(uint32_t p) const;       // порядок на процессоре p
+    std::span<const uint64_t> completion(uint32_t p) const; // C_i в том же порядке
+
+private:
+    const uint8_t* base_{nullptr};
+    size_t size_{0};
+    uint32_t N_{0}, M_{0};
+    uint64_t K2_{0};
+};
@@ -0,0 +1,176 @@
+#include "multichain.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace {
+inline uint64_t xorshift(uint64_t& s) {
+    s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+    return s * 2685821657736338717ull;
+}
+inline uint32_t below(uint64_t r, uint32_t n) { return uint32_t(((r >> 32) * uint64_t(n)) >> 32); }
+} // namespace
+
+template <unsigned L>
+MultiChainSA<L>::MultiChainSA(const Instance& I, SAParams p) : inst_(&I), P_(p) {
+    const uint32_t N = I.N, M = I.M;
+    const size_t treeCells = size_t(M) * (size_t(N) + 1) * L;
+    if (M == 0 || treeCells > kMaxTreeBytes / (2 * sizeof(int64_t))) return;
+    ok_ = true;
+    levels_ = std::bit_width(N);
+    byRank_.resize(N + 1);
+    std::iota(byRank_.begin() + 1, byRank_.end(), 0u);
+    std::stable_sort(byRank_.begin() + 1, byRank_.end(), [&](uint32_t a, uint32_t b) { return I.t[a] < I.t[b]; });
+    rank_.resize(N);
+    for (uint32_t r = 1; r <= N; ++r) rank_[byRank_[r]] = r;
+
+    cnt_.assign(treeCells, 0);
+    sum_.assign(treeCells, 0);
+    cntTot_.assign(size_t(M) * L, 0);
+    assign_.resize(size_t(N) * L);
+
+    // все 64 бита сида; состояния собираем из пар 32-битных слов
+    std::seed_seq seq{uint32_t(p.seed), uint32_t(p.seed >> 32)};
+    uint32_t words[2 * L];
+    seq.generate(words, words + 2 * L);
+    for (unsigned l = 0; l < L; ++l)
+        rng_[l] = (uint64_t(words[2 * l]) | (uint64_t(words[2 * l + 1]) << 32)) | 1; // xorshift не любит нулевое состояние
+
+    // случайный старт; К2 копим по SPT: работа ранга r добавляется в конец своего процессора
+    for (unsigned l = 0; l < L; ++l) k2_[l] = 0;
+    std::vector<int64_t> load(size_t(M) * L, 0);
+    for (uint32_t r = 1; r <= N; ++r) {
+        uint32_t job = byRank_[r], proc[L], pos[L];
+        int64_t one[L], t[L];
+        for (unsigned l = 0; l < L; ++l) {
+            proc[l] = below(xorshift(rng_[l]), M);
+            pos[l] = r;
+            one[l] = 1;
+            t[l] = I.t[job];
+            assign_[size_t(job) * L + l] = proc[l];
+            int64_t& ld = load[size_t(proc[l]) * L + l];
+            ld += t[l];
+            k2_[l] += ld;
+            ++cntTot_[size_t(proc[l]) * L + l];
+        }
+        add(cnt_.data(), proc, pos, one);
+        add(sum_.data(), proc, pos, t);
+    }
+    std::copy(k2_, k2_ + L, bestK2_);
+    bestAssign_ = assign_;
+}
+
+// out[l] = sum tree[proc[l]][1..pos[l]]; фиксированное число шагов с маской — без ветвлений по lane
+template <unsigned L>
+void MultiChainSA<L>::prefix(const int64_t* tree, const uint32_t* proc, const uint32_t* pos, int64_t* out) const {
+    const size_t stride = size_t(inst_->N) + 1;
+    uint32_t i[L];
+    for (unsigned l = 0; l < L; ++l) { i[l] = pos[l]; out[l] = 0; }
+    for (uint32_t k = 0; k < levels_; ++k)
+        for (unsigned l = 0; l < L; ++l) {
+            int64_t v = tree[(proc[l] * stride + i[l]) * L + l];
+            out[l] += i[l] ? v : 0;
+            i[l] &= i[l] - 1;
+        }
+}
+
+template <unsigned L>
+void MultiChainSA<L>::add(int64_t* tree, const uint32_t* proc, const uint32_t* pos, const int64_t* w) {
+    const uint32_t N = inst_->N;
+    const size_t stride = size_t(N) + 1;
+    uint32_t i[L];
+    for (unsigned l = 0; l < L; ++l) i[l] = pos[l];
+    for (uint32_t k = 0; k < levels_; ++k)
+        for (unsigned l = 0; l < L; ++l) {
+            uint32_t idx = i[l] <= N ? i[l] : 0; // узел 0 не читается prefix'ом — годится как сток
+            tree[(proc[l] * stride + idx) * L + l] += w[l];
+            i[l] += i[l] & (0u - i[l]);
+        }
+}
+
+template <unsigned L>
+void MultiChainSA<L>::run(ITempSchedule& temp) {
+    const Instance& I = *inst_;
+    const uint32_t N = I.N, M = I.M;
+    if (!ok_ || N == 0 || M < 2) return;
+    temp.reset(P_.T0);
+    size_t noImprove = 0;
+
+    uint32_t job[L], r[L], rPrev[L], p[L], q[L];
+    int64_t x[L], sp[L], cp[L], sq[L], cq[L], d[L], w[L], wx[L], nw[L], nwx[L];
+    double u[L];
+
+    while (temp.current() > P_.Tmin && noImprove < P_.patienceK) {
+        const double invT = 1.0 / temp.current();
+        for (size_t it = 0; it < P_.itersPerT; ++it) {
+            // случайный ход в каждой цепочке; u — из своего слова, иначе приём зависел бы от q
+            for (unsigned l = 0; l < L; ++l) {
+                uint64_t a = xorshift(rng_[l]), b = xorshift(rng_[l]), c = xorshift(rng_[l]);
+                job[l] = below(a, N);
+                r[l] = rank_[job[l]];
+                rPrev[l] = r[l] - 1;
+                x[l] = I.t[job[l]];
+                p[l] = assign_[size_t(job[l]) * L + l];
+                q[l] = (p[l] + 1 + below(b, M - 1)) % M;
+                u[l] = double(c >> 11) * 0x1.0p-53;
+            }
+            prefix(sum_.data(), p, rPrev, sp);
+            prefix(cnt_.data(), p, r, cp);
+            prefix(sum_.data(), q, rPrev, sq);
+            prefix(cnt_.data(), q, rPrev, cq);
+
+            // вклад работы в процессор: x + сумма более коротких + x * число более длинных
+            for (unsigned l = 0; l < L; ++l) {
+                int64_t outP = x[l] + sp[l] + x[l] * (cntTot_[size_t(p[l]) * L + l] - cp[l]);
+                int64_t inQ = x[l] + sq[l] + x[l] * (cntTot_[size_t(q[l]) * L + l] - cq[l]);
+                d[l] = inQ - outP;
+                double e = std::exp(std::min(0.0, -double(d[l]) * invT));
+                int64_t acc = u[l] < e;
+                w[l] = acc; wx[l] = acc * x[l];
+                nw[l] = -w[l]; nwx[l] = -wx[l];
+                k2_[l] += acc * d[l];
+                cntTot_[size_t(p[l]) * L + l] -= acc;
+                cntTot_[size_t(q[l]) * L + l] += acc;
+                assign_[size_t(job[l]) * L + l] = acc ? q[l] : p[l];
+            }
+            add(cnt_.data(), p, r, nw);
+            add(sum_.data(), p, r, nwx);
+            add(cnt_.data(), q, r, w);
+            add(sum_.data(), q, r, wx);
+        }
+
+        // снимок лучших раз в температурный уровень: копия O(N) на каждое улучшение слишком дорога
+        bool improved = false;
+        for (unsigned l = 0; l < L; ++l) {
+            if (k2_[l] >= bestK2_[l]) continue;
+            improved = true;
+            bestK2_[l] = k2_[l];
+            for (uint32_t i = 0; i < N; ++i) bestAssign_[size_t(i) * L + l] = assign_[size_t(i) * L + l];
+        }
+        noImprove = improved ? 0 : noImprove + 1;
+        temp.next();
+    }
+}
+
+template <unsigned L>
+std::vector<std::unique_ptr<ScheduleSolution>> MultiChainSA<L>::winners(size_t k) const {
+    unsigned order[L];
+    std::iota(order, order + L, 0u);
+    std::sort(order, order + L, [&](unsigned a, unsigned b) { return bestK2_[a] < bestK2_[b]; });
+    std::vector<std::unique_ptr<ScheduleSolution>> out;
+    if (!ok_) return out;
+    for (size_t n = 0; n < std::min<size_t>(k, L); ++n) {
+        auto S = std::make_unique<ScheduleSolution>(inst_);
+        for (uint32_t r = 1; r <= inst_->N; ++r) {
+            uint32_t job = byRank_[r];
+            S->G[bestAssign_[size_t(job) * L + order[n]]].push_back(job);
+        }
+        S->rebuildHFromOrders();
+        out.push_back(std::move(S));
+    }
+    return out;
+}
+
+template class MultiChainSA<8>;
+template class MultiChainSA<16>;
@@ -0,0 +1,43 @@
+#pragma once
+#include "schedule.hpp"
+
+// L независимых цепочек ИО над одним Instance, шаг в шаг (мультистарт на одном ядре).
+// Состояние цепочки: назначение работа->процессор; порядок на процессоре неявно SPT,
+// поэтому К2 процессора выражается через префиксные суммы длительностей по SPT-рангу.
+// Они хранятся в деревьях Фенвика, раскладка structure-of-arrays: [proc][node][lane],
+// так что каждый цикл по lane (ГСЧ, ΔK2, Метрополис, обновление) векторизуется.
+// Шаг: каждая цепочка переносит случайную работу на случайный другой процессор.
+// Деревья плотные: 2 * M * (N+1) * L чисел int64. Если это больше kMaxTreeBytes,
+// инстанс отвергается (ok() == false, run() ничего не делает, winners() пуст).
+template <unsigned L>
+class MultiChainSA {
+public:
+    static constexpr size_t kMaxTreeBytes = size_t(1) << 30;
+
+    MultiChainSA(const Instance& I, SAParams p);
+    bool ok() const { return ok_; }
+    void run(ITempSchedule& temp);
+
+    uint64_t bestK2(unsigned lane) const { return uint64_t(bestK2_[lane]); }
+    // k лучших цепочек в виде ScheduleSolution (Gj в SPT-порядке) — старты для run_parallel
+    std::vector<std::unique_ptr<ScheduleSolution>> winners(size_t k) const;
+
+private:
+    void prefix(const int64_t* tree, const uint32_t* proc, const uint32_t* pos, int64_t* out) const;
+    void add(int64_t* tree, const uint32_t* proc, const uint32_t* pos, const int64_t* w);
+
+    const Instance* inst_;
+    SAParams P_;
+    bool ok_{false};
+    uint32_t levels_{0};              // число шагов Фенвика: bit_width(N)
+    std::vector<uint32_t> rank_;      // job -> SPT-ранг (1..N)
+    std::vector<uint32_t> byRank_;    // ранг -> job
+    std::vector<int64_t> cnt_, sum_;  // Фенвик [(proc*(N+1) + node)*L + lane]
+    std::vector<int64_t> cntTot_;     // [proc*L + lane]
+    std::vector<uint32_t> assign_, bestAssign_; // [job*L + lane]
+    uint64_t rng_[L];
+    int64_t k2_[L], bestK2_[L];
+};
+
+extern template class MultiChainSA<8>;
+extern template class MultiChainSA<16>;
@@ -11,4 +11,26 @@ struct MoveBetweenProcs : IMutation {
 
 struct ReassignGreedy : IMutation {
     void apply(ISolution& s, std::mt19937_64& rng) override; // перекинуть работу на другой проц. в лучшую позицию локально по ΔK2
-};
\ No newline at end of file
+};
+
+// Составная мутация: выбирает оператор бандитом (discounted UCB1).
+// Награда оператора = улучшение К2 / CPU-наносекунды его apply, со старением decay,
+// поэтому по ходу охлаждения доля дорогих/дешёвых операторов сдвигается сама.
+// Улучшение берётся из feedback(delta) движка — сама мутация objective() не считает.
+struct AdaptiveMutation : IMutation {
+    explicit AdaptiveMutation(std::vector<std::unique_ptr<IMutation>> ops,
+                              double decay = 0.999, double explore = 0.5);
+    void apply(ISolution& s, std::mt19937_64& rng) override;
+    void feedback(double delta) override; // награда оператору последнего apply
+
+    struct Arm {
+        std::unique_ptr<IMutation> op;
+        double n{0}, reward{0}; // дисконтированные число вызовов и сумма наград
+        uint64_t pulls{0};
+    };
+    size_t pick() const;
+    std::vector<Arm> arms;
+    double decay{0.999}, explore{0.5}, total{0};
+    size_t last{SIZE_MAX};  // оператор последнего apply, ждёт feedback
+    uint64_t lastNs{1};     // его время
+};
@@ -0,0 +1,114 @@
+#include "objective.hpp"
+#include <algorithm>
+
+ObjectiveSolution::ObjectiveSolution(const Instance* inst, ObjectiveKind kind_, double wK2_, double wCmax_)
+    : ScheduleSolution(inst), kind(kind_), wK2(wK2_), wCmax(wCmax_) {
+    while (leaves_ < inst_->M) leaves_ *= 2;
+    tree_.assign(2 * size_t(leaves_), 0);
+}
+
+void ObjectiveSolution::set_load(uint32_t j, uint64_t v) {
+    size_t i = leaves_ + j;
+    tree_[i] = v;
+    for (i /= 2; i >= 1; i /= 2) tree_[i] = std::max(tree_[2 * i], tree_[2 * i + 1]);
+}
+
+uint32_t ObjectiveSolution::argmax_load() const {
+    // влево при равенстве: пустые листы-добивки справа, так что всегда попадаем в j < M
+    size_t i = 1;
+    while (i < leaves_) i = tree_[2 * i] >= tree_[2 * i + 1] ? 2 * i : 2 * i + 1;
+    return uint32_t(i - leaves_);
+}
+
+void ObjectiveSolution::recompute() {
+    std::fill(tree_.begin(), tree_.end(), 0);
+    k2_ = 0;
+    for (uint32_t j = 0; j < G.size(); ++j) {
+        uint64_t acc = 0;
+        for (uint32_t i : G[j]) { acc += inst_->t[i]; k2_ += acc; }
+        tree_[leaves_ + j] = acc;
+    }
+    for (size_t i = leaves_ - 1; i >= 1; --i) tree_[i] = std::max(tree_[2 * i], tree_[2 * i + 1]);
+}
+
+double ObjectiveSolution::objective() const {
+    switch (kind) {
+    case ObjectiveKind::Makespan: return double(makespan());
+    case ObjectiveKind::Blend: return wK2 * double(k2_) + wCmax * double(makespan());
+    case ObjectiveKind::K2:
+    default: return double(k2_);
+    }
+}
+
+void ObjectiveSolution::swapIn(uint32_t j, size_t x, size_t y) {
+    auto& Gj = G[j];
+    if (x > y) std::swap(x, y);
+    int64_t d = (int64_t(inst_->t[Gj[y]]) - int64_t(inst_->t[Gj[x]])) * int64_t(y - x);
+    k2_ = uint64_t(int64_t(k2_) + d);
+    std::swap(Gj[x], Gj[y]); // обе работы остаются на j — строки H не меняются
+}
+
+void ObjectiveSolution::move(uint32_t a, size_t k, uint32_t b, size_t l) {
+    auto& A = G[a];
+    const uint32_t job = A[k];
+    const uint64_t t = inst_->t[job];
+
+    // из a: пропадает C_k, все следующие завершаются на t раньше
+    uint64_t preA = 0;
+    for (size_t r = 0; r <= k; ++r) preA += inst_->t[A[r]];
+    k2_ -= preA + t * (A.size() - 1 - k);
+    A.erase(A.begin() + k);
+    set_load(a, load(a) - t);
+
+    // в b: новая работа завершается в pre(l-1) + t, все следующие — на t позже
+    auto& B = G[b];
+    l = std::min(l, B.size());
+    uint64_t preB = 0;
+    for (size_t r = 0; r < l; ++r) preB += inst_->t[B[r]];
+    k2_ += preB + t + t * (B.size() - l);
+    B.insert(B.begin() + l, job);
+    set_load(b, load(b) + t);
+
+    // H держим согласованной с G: решение уходит наружу (serialize, widen) без rebuildHFromOrders
+    H[size_t(job) * inst_->M + a] = 0;
+    H[size_t(job) * inst_->M + b] = 1;
+}
+
+std::unique_ptr<ISolution> ObjectiveSolution::clone() const {
+    return std::make_unique<ObjectiveSolution>(*this);
+}
+
+void ObjectiveSolution::randomize(std::mt19937_64& rng) {
+    ScheduleSolution::randomize(rng);
+    recompute();
+}
+
+bool ObjectiveSolution::deserialize(const uint8_t* p, size_t n) {
+    if (!ScheduleSolution::deserialize(p, n)) return false;
+    recompute();
+    return true;
+}
+
+void ObjSwapInProc::apply(ISolution& s, std::mt19937_64& rng) {
+    auto& S = static_cast<ObjectiveSolution&>(s);
+    uint32_t j = uint32_t(rng() % S.G.size());
+    if (S.G[j].size() < 2) return;
+    S.swapIn(j, rng() % S.G[j].size(), rng() % S.G[j].size());
+}
+
+void ObjMoveBetweenProcs::apply(ISolution& s, std::mt19937_64& rng) {
+    auto& S = static_cast<ObjectiveSolution&>(s);
+    const uint32_t M = uint32_t(S.G.size());
+    if (M < 2) return;
+    uint32_t a = uint32_t(rng() % M);
+    if (S.G[a].empty()) return;
+    // для makespan полезнее разгружать самый загруженный процессор
+    if (S.kind != ObjectiveKind::K2 && rng() % 2) a = S.argmax_load();
+    if (S.G[a].empty()) return; // при нулевых длительностях самым загруженным может оказаться пустой
+    uint32_t b = (a + 1 + uint32_t(rng() % (M - 1))) % M;
+    S.move(a, rng() % S.G[a].size(), b, rng() % (S.G[b].size() + 1));
+}
+
+std::unique_ptr<ObjectiveSolution> make_objective_solution(const Instance* inst, const SAParams& p) {
+    return std::make_unique<ObjectiveSolution>(inst, p.objective, p.wK2, p.wCmax);
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "schedule.hpp"
+
+// Выбираемый в рантайме критерий: К2, makespan (Cmax = max нагрузки процессора) или смесь.
+// ObjectiveSolution держит К2 и нагрузки по процессорам, а для Cmax — дерево отрезков
+// максимумов над нагрузками: ход обновляет два листа за O(log M).
+// Ходы выполняются методами swapIn/move (через ObjSwapInProc/ObjMoveBetweenProcs),
+// которые считают ΔK2 локально, поэтому objective() — O(1), без evalK2.
+// Цена хода: swapIn — O(1); move — O(n_a + n_b) по числу работ на двух процессорах
+// (префиксы до k и l плюс erase/insert в deque) и O(log M) на дерево нагрузок.
+// Мутации ScheduleSolution (SwapInProc и др.) кэш не обновляют — с этим решением их не использовать.
+struct ObjectiveSolution : ScheduleSolution {
+    ObjectiveSolution(const Instance* inst, ObjectiveKind kind, double wK2 = 1.0, double wCmax = 0.0);
+
+    uint64_t k2() const { return k2_; }
+    uint64_t makespan() const { return tree_[1]; }
+    uint64_t load(uint32_t j) const { return tree_[leaves_ + j]; }
+    // Самый загруженный процессор (при равенстве — меньший номер), спуском по дереву за O(log M)
+    uint32_t argmax_load() const;
+
+    // Обмен позиций x и y в Gj: ΔK2 = (t_y - t_x) * (y - x), нагрузка не меняется
+    void swapIn(uint32_t j, size_t x, size_t y);
+    // Работа с позиции k процессора a вставляется в позицию l процессора b
+    void move(uint32_t a, size_t k, uint32_t b, size_t l);
+    // Пересчёт всех кэшей с нуля (после внешних правок G)
+    void recompute();
+
+    double objective() const override;
+    std::unique_ptr<ISolution> clone() const override;
+    void randomize(std::mt19937_64& rng) override;
+    bool deserialize(const uint8_t* p, size_t n) override;
+
+    ObjectiveKind kind;
+    double wK2, wCmax;
+
+private:
+    void set_load(uint32_t j, uint64_t v);
+    uint64_t k2_{0};
+    uint32_t leaves_{1};
+    std::vector<uint64_t> tree_; // [1] — корень, листья с leaves_
+};
+
+struct ObjSwapInProc : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override;
+};
+
+struct ObjMoveBetweenProcs : IMutation {
+    void apply(ISolution& s, std::mt19937_64& rng) override;
+};
+
+std::unique_ptr<ObjectiveSolution> make_objective_solution(const Instance* inst, const SAParams& p);
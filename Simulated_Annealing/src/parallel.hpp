@@ -7,7 +7,14 @@
 // Периодически шлют BEST; мастер хранит globalBest и рассылает его всем.
 // Останов: 10 внешних итераций без улучшения (из задания).
 // seq-режим: просто запускаем один локальный ИО без форка.
-struct ParParams { uint32_t nproc{4}; uint32_t outerPatience{10}; std::string sockPath{"/tmp/sa.sock"}; };
+// pinWorkers: воркер rank садится на (firstCore + rank)-й разрешённый CPU и держит свою реплику Instance
+// на NUMA-узле этого ядра (см. affinity.hpp).
+struct ParParams {
+    uint32_t nproc{4}; uint32_t outerPatience{10}; std::string sockPath{"/tmp/sa.sock"};
+    bool pinWorkers{false}; int firstCore{0};
+    std::string checkpointDir{};     // пусто — без снимков; иначе старт из <dir>/worker_k.ck, если он есть
+    double checkpointEverySec{60.0}; // снимки пишет фоновый CheckpointWriter (checkpoint.hpp)
+};
 
 int run_sequential(const Instance& I, SAParams sa, unsigned seedOverride,
                    std::unique_ptr<IMutation> mut,
@@ -0,0 +1,179 @@
+#include "perf_counters.hpp"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace {
+constexpr uint64_t cache_cfg(uint64_t cache, uint64_t op, uint64_t res) {
+    return cache | (op << 8) | (res << 16);
+}
+
+const struct { uint32_t type; uint64_t config; const char* name; } kEvents[PE_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instr"},
+    {PERF_TYPE_HW_CACHE, cache_cfg(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), "L1d-miss"},
+    {PERF_TYPE_HW_CACHE, cache_cfg(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS), "LLC-miss"},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "br-miss"},
+};
+
+const char* kPhaseNames[size_t(SAPhase::Count)] = {"move", "evaluate", "accept"};
+
+int perf_open(uint32_t type, uint64_t config, int group) {
+    perf_event_attr a;
+    std::memset(&a, 0, sizeof(a));
+    a.size = sizeof(a);
+    a.type = type;
+    a.config = config;
+    a.disabled = group < 0;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    a.read_format = PERF_FORMAT_GROUP;
+    return int(syscall(SYS_perf_event_open, &a, 0, -1, group, 0));
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+inline uint64_t rdpmc(uint32_t counter) {
+    uint32_t lo, hi;
+    asm volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(counter));
+    return lo | (uint64_t(hi) << 32);
+}
+
+// Значение счётчика по протоколу perf_event_mmap_page (seqlock lock/index/offset).
+// false, если событие сейчас не на PMU (index == 0) — тогда нужен read()
+bool mmap_count(const perf_event_mmap_page* pc, uint64_t& value) {
+    uint32_t seq;
+    do {
+        seq = pc->lock;
+        asm volatile("" ::: "memory");
+        uint32_t idx = pc->index;
+        if (!pc->cap_user_rdpmc || idx == 0) return false;
+        uint64_t pmc = rdpmc(idx - 1);
+        uint16_t width = pc->pmc_width;
+        int64_t delta = int64_t(pmc << (64 - width)) >> (64 - width); // знаковое расширение
+        value = uint64_t(pc->offset + delta);
+        asm volatile("" ::: "memory");
+    } while (pc->lock != seq);
+    return true;
+}
+#else
+bool mmap_count(const perf_event_mmap_page*, uint64_t&) { return false; }
+#endif
+
+double per_k(uint64_t num, uint64_t instr) { return instr ? 1000.0 * double(num) / double(instr) : 0.0; }
+} // namespace
+
+bool PerfCounters::open() {
+    close();
+    for (int e = 0; e < PE_COUNT; ++e) {
+        int fd = perf_open(kEvents[e].type, kEvents[e].config, leader_);
+        if (fd < 0) continue;
+        if (leader_ < 0) leader_ = fd;
+        fd_[e] = fd;
+        slot_[e] = nopen_++;
+    }
+    if (leader_ < 0) return false;
+    ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+    // rdpmc, только если он есть у всех открытых событий
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    rdpmc_ = true;
+    for (int e = 0; e < PE_COUNT; ++e) {
+        if (fd_[e] < 0) continue;
+        void* p = mmap(nullptr, size_t(pageSize), PROT_READ, MAP_SHARED, fd_[e], 0);
+        if (p == MAP_FAILED) { rdpmc_ = false; continue; }
+        page_[e] = p;
+        uint64_t probe;
+        if (!mmap_count(static_cast<const perf_event_mmap_page*>(p), probe)) rdpmc_ = false;
+    }
+    return true;
+}
+
+void PerfCounters::close() {
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    for (int e = 0; e < PE_COUNT; ++e) {
+        if (page_[e]) munmap(page_[e], size_t(pageSize));
+        page_[e] = nullptr;
+        if (fd_[e] >= 0) ::close(fd_[e]);
+        fd_[e] = -1;
+    }
+    leader_ = -1;
+    nopen_ = 0;
+    rdpmc_ = false;
+}
+
+bool PerfCounters::read_rdpmc(uint64_t (&out)[PE_COUNT]) const {
+    for (int e = 0; e < PE_COUNT; ++e) {
+        out[e] = 0;
+        if (fd_[e] >= 0 && !mmap_count(static_cast<const perf_event_mmap_page*>(page_[e]), out[e]))
+            return false;
+    }
+    return true;
+}
+
+bool PerfCounters::read(uint64_t (&out)[PE_COUNT]) const {
+    if (rdpmc_ && read_rdpmc(out)) return true;
+    uint64_t buf[1 + PE_COUNT];
+    if (leader_ < 0 || ::read(leader_, buf, sizeof(buf)) < ssize_t((1 + nopen_) * sizeof(uint64_t))) {
+        std::memset(out, 0, sizeof(out));
+        return false;
+    }
+    for (int e = 0; e < PE_COUNT; ++e) out[e] = fd_[e] >= 0 ? buf[1 + slot_[e]] : 0;
+    return true;
+}
+
+void PhaseProfiler::begin(SAPhase ph) {
+    if (!opened_) {
+        opened_ = true;
+        pc_.open();
+        every_ = pc_.userspace() ? 1 : kFallbackSampleEvery;
+    }
+    active_ = calls_[size_t(ph)]++ % every_ == 0;
+    if (active_) pc_.read(start_);
+}
+
+void PhaseProfiler::end(SAPhase ph) {
+    if (!active_) return;
+    uint64_t now[PE_COUNT];
+    pc_.read(now);
+    auto& acc = acc_[size_t(ph)];
+    for (int e = 0; e < PE_COUNT; ++e) acc[e] += now[e] - start_[e];
+    ++sampled_[size_t(ph)];
+}
+
+void PhaseProfiler::report(std::FILE* f) const {
+    if (!pc_.ok()) {
+        std::fprintf(f, "SA profile: perf_event_open unavailable (check perf_event_paranoid)\n");
+        return;
+    }
+    // при выборочном замере оцениваем сумму по всем вызовам фазы
+    uint64_t est[size_t(SAPhase::Count)][PE_COUNT]{};
+    uint64_t totalCycles = 0;
+    for (size_t p = 0; p < size_t(SAPhase::Count); ++p) {
+        double scale = sampled_[p] ? double(calls_[p]) / double(sampled_[p]) : 0.0;
+        for (int e = 0; e < PE_COUNT; ++e) est[p][e] = uint64_t(double(acc_[p][e]) * scale);
+        totalCycles += est[p][PE_CYCLES];
+    }
+
+    if (every_ == 1) std::fprintf(f, "SA profile (per phase, rdpmc, every call)\n");
+    else std::fprintf(f, "SA profile (per phase, read() on 1/%llu of calls, scaled)\n", (unsigned long long)every_);
+    std::fprintf(f, "%-9s %10s", "phase", "calls");
+    for (const auto& ev : kEvents) std::fprintf(f, " %14s", ev.name);
+    std::fprintf(f, " %6s %6s %9s %9s %9s\n", "cyc%", "IPC", "L1d/ki", "LLC/ki", "br/ki");
+    for (size_t p = 0; p < size_t(SAPhase::Count); ++p) {
+        const auto& a = est[p];
+        std::fprintf(f, "%-9s %10llu", kPhaseNames[p], (unsigned long long)calls_[p]);
+        for (int e = 0; e < PE_COUNT; ++e) {
+            if (pc_.has(PerfEvent(e))) std::fprintf(f, " %14llu", (unsigned long long)a[e]);
+            else std::fprintf(f, " %14s", "n/a");
+        }
+        std::fprintf(f, " %6.1f %6.2f %9.2f %9.2f %9.2f\n",
+                     totalCycles ? 100.0 * double(a[PE_CYCLES]) / double(totalCycles) : 0.0,
+                     a[PE_CYCLES] ? double(a[PE_INSTR]) / double(a[PE_CYCLES]) : 0.0,
+                     per_k(a[PE_L1D_MISS], a[PE_INSTR]), per_k(a[PE_LLC_MISS], a[PE_INSTR]),
+                     per_k(a[PE_BRANCH_MISS], a[PE_INSTR]));
+    }
+}
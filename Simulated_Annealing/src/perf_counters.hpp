@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+// Аппаратные счётчики (perf_event_open) для фаз горячего цикла ИО:
+// Move (mutation->apply), Evaluate (objective), Accept (exp + сравнение).
+// Включается только сборкой с -DSA_PROFILE; без флага макросы раскрываются в пустоту.
+// PhaseProfiler при этом всё равно остаётся членом SimulatedAnnealing (раскладка класса
+// одна во всех единицах трансляции), но счётчики не открывает — они открываются при первом begin().
+//
+// Фазы короче микросекунды, поэтому счётчики читаются из пространства пользователя:
+// rdpmc через mmap-страницу события (x86, cap_user_rdpmc). Если rdpmc недоступен, остаётся
+// read() группы — системный вызов сам по себе дороже фазы, так что тогда замеряется
+// только каждый kFallbackSampleEvery-й вызов фазы, а в отчёте суммы масштабируются на все вызовы.
+
+enum class SAPhase : uint8_t { Move, Evaluate, Accept, Count };
+
+enum PerfEvent : uint8_t { PE_CYCLES, PE_INSTR, PE_L1D_MISS, PE_LLC_MISS, PE_BRANCH_MISS, PE_COUNT };
+
+// Группа из PE_COUNT счётчиков на текущем потоке; недоступные события пропускаются
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    ~PerfCounters() { close(); }
+
+    bool open();
+    void close();
+    bool ok() const { return leader_ >= 0; }
+    bool has(PerfEvent e) const { return fd_[e] >= 0; }
+    bool read(uint64_t (&out)[PE_COUNT]) const; // отсутствующие события = 0
+    bool userspace() const { return rdpmc_; }   // read() без системного вызова
+
+private:
+    bool read_rdpmc(uint64_t (&out)[PE_COUNT]) const;
+
+    int leader_{-1};
+    int fd_[PE_COUNT]{-1, -1, -1, -1, -1};
+    void* page_[PE_COUNT]{};   // perf_event_mmap_page каждого события (для rdpmc)
+    bool rdpmc_{false};
+    uint8_t slot_[PE_COUNT]{}; // позиция события в групповом чтении
+    uint8_t nopen_{0};
+};
+
+class PhaseProfiler {
+public:
+    static constexpr uint64_t kFallbackSampleEvery = 64;
+
+    void begin(SAPhase ph);
+    void end(SAPhase ph);
+    void report(std::FILE* f = stderr) const;
+
+private:
+    PerfCounters pc_;
+    bool opened_{false};
+    bool active_{false};      // текущий вызов фазы замеряется
+    uint64_t every_{1};       // 1 при rdpmc, kFallbackSampleEvery при read()
+    uint64_t start_[PE_COUNT]{};
+    uint64_t acc_[size_t(SAPhase::Count)][PE_COUNT]{};
+    uint64_t calls_[size_t(SAPhase::Count)]{};
+    uint64_t sampled_[size_t(SAPhase::Count)]{};
+};
+
+struct PhaseScope {
+    PhaseScope(PhaseProfiler& p, SAPhase ph) : p_(p), ph_(ph) { p_.begin(ph_); }
+    ~PhaseScope() { p_.end(ph_); }
+    PhaseProfiler& p_;
+    SAPhase ph_;
+};
+
+#define SA_PROF_CAT2(a, b) a##b
+#define SA_PROF_CAT(a, b) SA_PROF_CAT2(a, b)
+#ifdef SA_PROFILE
+#define SA_PROF_SCOPE(prof, phase) PhaseScope SA_PROF_CAT(sa_prof_scope_, __LINE__){prof, phase}
+#define SA_PROF_REPORT(prof) (prof).report()
+#else
+#define SA_PROF_SCOPE(prof, phase) ((void)0)
+#define SA_PROF_REPORT(prof) ((void)0)
+#endif
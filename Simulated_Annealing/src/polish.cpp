@@ -0,0 +1,181 @@
+#include "polish.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace {
+// Отсортированные длительности процессора, префиксные суммы и различные значения
+struct ProcView {
+    std::vector<int64_t> d, pre, vals;
+};
+
+// Потоки живут всё время polish_schedule; на каждой итерации улучшения им только раздаётся работа.
+// parallel_for(n, f) зовёт f(i, w) для i из [0, n): воркер w берёт i = w, w + size(), ...
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned threads) : n_(std::max(1u, threads)) {
+        for (unsigned w = 1; w < n_; ++w) pool_.emplace_back([this, w] { loop(w); });
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            stop_ = true;
+            ++gen_;
+        }
+        start_.notify_all();
+        for (auto& th : pool_) th.join();
+    }
+
+    unsigned size() const { return n_; }
+
+    void parallel_for(size_t n, const std::function<void(size_t, unsigned)>& f) {
+        if (n_ == 1) {
+            for (size_t i = 0; i < n; ++i) f(i, 0u);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            job_ = &f;
+            count_ = n;
+            pending_ = n_ - 1;
+            ++gen_;
+        }
+        start_.notify_all();
+        share(0);
+        std::unique_lock<std::mutex> lk(m_);
+        done_.wait(lk, [&] { return pending_ == 0; });
+    }
+
+private:
+    void share(unsigned w) {
+        for (size_t i = w; i < count_; i += n_) (*job_)(i, w);
+    }
+
+    void loop(unsigned w) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lk(m_);
+        for (;;) {
+            start_.wait(lk, [&] { return gen_ != seen; });
+            seen = gen_;
+            if (stop_) return;
+            lk.unlock();
+            share(w);
+            lk.lock();
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    unsigned n_;
+    std::vector<std::thread> pool_;
+    std::mutex m_;
+    std::condition_variable start_, done_;
+    const std::function<void(size_t, unsigned)>* job_{nullptr};
+    size_t count_{0};
+    unsigned pending_{0};
+    uint64_t gen_{0};
+    bool stop_{false};
+};
+
+void sort_spt(std::deque<uint32_t>& Gj, const Instance& I) {
+    std::stable_sort(Gj.begin(), Gj.end(), [&](uint32_t a, uint32_t b) { return I.t[a] < I.t[b]; });
+}
+
+void build_view(const std::deque<uint32_t>& Gj, const Instance& I, ProcView& v) {
+    v.d.clear(); v.pre.assign(1, 0); v.vals.clear();
+    for (uint32_t i : Gj) {
+        int64_t t = I.t[i];
+        v.d.push_back(t);
+        v.pre.push_back(v.pre.back() + t);
+        if (v.vals.empty() || v.vals.back() != t) v.vals.push_back(t);
+    }
+}
+
+// ΔK2 процессора, если одну работу длительности x (она есть в v) заменить на работу длительности y.
+// Вклад пары (x, t) в К2 равен min(x, t), поэтому Δ = (y-x) + sum_t [min(y,t) - min(x,t)] - [min(y,x) - x].
+int64_t delta_replace(const ProcView& v, int64_t x, int64_t y) {
+    if (x == y) return 0;
+    const int64_t n = int64_t(v.d.size());
+    auto lb = [&](int64_t a) { return int64_t(std::lower_bound(v.d.begin(), v.d.end(), a) - v.d.begin()); };
+    auto ub = [&](int64_t a) { return int64_t(std::upper_bound(v.d.begin(), v.d.end(), a) - v.d.begin()); };
+    if (y > x) {
+        int64_t lo = ub(x), hi = lb(y); // x < t < y
+        int64_t mid = (v.pre[hi] - v.pre[lo]) - x * (hi - lo);
+        return (y - x) + mid + (y - x) * (n - hi);
+    }
+    int64_t lo = ub(y), hi = lb(x); // y < t < x
+    int64_t mid = y * (hi - lo) - (v.pre[hi] - v.pre[lo]);
+    return mid + (y - x) * (n - hi); // (y-x) за саму работу сокращается с её собственным слагаемым
+}
+
+struct Swap {
+    int64_t delta{0};
+    uint32_t p{0}, q{0};
+    int64_t x{0}, y{0};
+};
+
+// Строгий порядок (delta, p, q, x, y): при равных выигрышах выбор не зависит от того,
+// как пары процессоров разошлись по потокам, поэтому результат один при любом threads
+bool better(const Swap& a, const Swap& b) {
+    return std::tie(a.delta, a.p, a.q, a.x, a.y) < std::tie(b.delta, b.p, b.q, b.x, b.y);
+}
+
+void move_job(std::deque<uint32_t>& from, std::deque<uint32_t>& to, int64_t t, const Instance& I) {
+    auto it = std::find_if(from.begin(), from.end(), [&](uint32_t i) { return I.t[i] == t; });
+    uint32_t job = *it;
+    from.erase(it);
+    auto pos = std::upper_bound(to.begin(), to.end(), job,
+                                [&](uint32_t a, uint32_t b) { return I.t[a] < I.t[b]; });
+    to.insert(pos, job);
+}
+} // namespace
+
+PolishStats polish_schedule(ScheduleSolution& S, unsigned threads) {
+    const Instance& I = *S.inst_;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    PolishStats st;
+    st.before = evalK2(S);
+
+    const size_t M = S.G.size();
+    WorkerPool pool(std::min<unsigned>(threads, unsigned(std::max<size_t>(M, 1))));
+    std::vector<ProcView> views(M);
+    pool.parallel_for(M, [&](size_t j, unsigned) {
+        sort_spt(S.G[j], I);
+        build_view(S.G[j], I, views[j]);
+    });
+
+    std::vector<Swap> best(pool.size());
+    while (M > 1) {
+        std::fill(best.begin(), best.end(), Swap{});
+        pool.parallel_for(M, [&](size_t p, unsigned w) {
+            const ProcView& vp = views[p];
+            for (size_t q = p + 1; q < M; ++q) {
+                const ProcView& vq = views[q];
+                for (int64_t x : vp.vals)
+                    for (int64_t y : vq.vals) {
+                        if (x == y) continue;
+                        int64_t d = delta_replace(vp, x, y) + delta_replace(vq, y, x);
+                        Swap c{d, uint32_t(p), uint32_t(q), x, y};
+                        if (d < 0 && better(c, best[w])) best[w] = c;
+                    }
+            }
+        });
+        Swap b = *std::min_element(best.begin(), best.end(), better);
+        if (b.delta >= 0) break;
+
+        move_job(S.G[b.p], S.G[b.q], b.x, I);
+        move_job(S.G[b.q], S.G[b.p], b.y, I);
+        build_view(S.G[b.p], I, views[b.p]);
+        build_view(S.G[b.q], I, views[b.q]);
+        ++st.swaps;
+    }
+
+    S.rebuildHFromOrders();
+    st.after = evalK2(S);
+    return st;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "schedule.hpp"
+
+// Детерминированная дошлифовка лучшего решения после ИО:
+//  1) каждый Gj сортируется по SPT (для одного процессора это оптимум К2);
+//  2) наискорейший спуск по обменам пар работ между процессорами, пока есть улучшение.
+// ΔK2 обмена считается за O(log n) по отсортированным длительностям процессора:
+// в SPT-порядке К2 = sum t + sum_{пары} min(t_a, t_b).
+// Поиск лучшего обмена и SPT-сортировка идут параллельно по процессорам.
+struct PolishStats {
+    uint64_t before{0}, after{0};
+    size_t swaps{0};
+};
+
+PolishStats polish_schedule(ScheduleSolution& S, unsigned threads = 0); // 0 = hardware_concurrency
@@ -0,0 +1,179 @@
+#include "restart.hpp"
+#include "schedule.hpp"
+#include "objective.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+void order_spt(ISolution& s) {
+    auto* S = dynamic_cast<ScheduleSolution*>(&s);
+    if (!S) return;
+    for (auto& Gj : S->G)
+        std::stable_sort(Gj.begin(), Gj.end(), [&](uint32_t a, uint32_t b) { return S->inst_->t[a] < S->inst_->t[b]; });
+    S->rebuildHFromOrders();
+    // у ObjectiveSolution свои кэши (К2, дерево нагрузок): после правки G их надо пересобрать,
+    // иначе objective() и все следующие дельты считаются от старого К2
+    if (auto* O = dynamic_cast<ObjectiveSolution*>(S)) {
+        O->recompute();
+        assert(O->k2() == evalK2(*O));
+    }
+}
+} // namespace
+
+RestartingAnnealer::RestartingAnnealer(std::unique_ptr<ISolution> init,
+                                       std::unique_ptr<IMutation> mut,
+                                       std::unique_ptr<ITempSchedule> temp,
+                                       SAParams p)
+    : cur_(std::move(init)), mut_(std::move(mut)), temp_(std::move(temp)), P_(p), rng_(p.seed) {
+    best_ = cur_->clone();
+}
+
+void RestartingAnnealer::restart() {
+    ++restarts_;
+    switch (P_.restart) {
+    case RestartPolicy::Reheat:
+        temp_->reset(P_.T0 * P_.reheatFrac);
+        break;
+    case RestartPolicy::PerturbBest:
+        cur_ = best_->clone();
+        for (size_t k = 0; k < P_.perturbMoves; ++k) mut_->apply(*cur_, rng_);
+        temp_->reset(P_.T0 * P_.reheatFrac);
+        break;
+    case RestartPolicy::FreshSeed:
+        cur_->randomize(rng_);
+        if (restarts_ % 2) order_spt(*cur_);
+        temp_->reset(P_.T0);
+        break;
+    case RestartPolicy::None:
+        break;
+    }
+}
+
+std::unique_ptr<ISolution> RestartingAnnealer::run() {
+    const auto t0 = Clock::now();
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    double curObj = cur_->objective(), bestObj = best_->objective();
+    double phaseBest = curObj; // patienceK считаем от лучшего в текущей фазе, иначе после рестарта сразу застой
+    size_t noImprove = 0, collapsed = 0;
+    temp_->reset(P_.T0);
+
+    while (true) {
+        // бюджет проверяем каждый уровень, а не только на застое: длинная фаза не должна его перерасходовать
+        if (P_.restart != RestartPolicy::None && P_.timeBudgetSec > 0 && since(t0) >= P_.timeBudgetSec) break;
+        const bool stagnated = temp_->current() <= P_.Tmin || noImprove >= P_.patienceK ||
+                               collapsed >= P_.collapseLevels;
+        if (stagnated) {
+            if (P_.restart == RestartPolicy::None || since(t0) >= P_.timeBudgetSec) break;
+            restart();
+            curObj = phaseBest = cur_->objective();
+            noImprove = collapsed = 0;
+        }
+        if (P_.target >= 0 && bestObj <= P_.target) {
+            stats_.secToTarget = since(t0);
+            break;
+        }
+
+        const double T = temp_->current();
+        bool improved = false;
+        uint64_t acc = 0;
+        for (size_t k = 0; k < P_.itersPerT; ++k) {
+            std::unique_ptr<ISolution> cand;
+            {
+                SA_PROF_SCOPE(prof_, SAPhase::Move);
+                cand = cur_->clone();
+                mut_->apply(*cand, rng_);
+            }
+            double candObj;
+            {
+                SA_PROF_SCOPE(prof_, SAPhase::Evaluate);
+                candObj = cand->objective();
+            }
+            SA_PROF_SCOPE(prof_, SAPhase::Accept);
+            double d = candObj - curObj;
+            mut_->feedback(d);
+            if (d <= 0 || U(rng_) < std::exp(-d / T)) {
+                cur_ = std::move(cand);
+                curObj = candObj;
+                ++acc;
+                if (curObj < phaseBest) {
+                    phaseBest = curObj;
+                    improved = true;
+                }
+                if (curObj < bestObj) {
+                    best_ = cur_->clone();
+                    bestObj = curObj;
+                }
+            }
+        }
+        stats_.iters += P_.itersPerT;
+        stats_.accepted += acc;
+        noImprove = improved ? 0 : noImprove + 1;
+        collapsed = double(acc) < P_.minAcceptRate * double(P_.itersPerT) ? collapsed + 1 : 0;
+        temp_->next();
+    }
+    SA_PROF_REPORT(prof_);
+    return best_->clone();
+}
+
+std::vector<RestartBenchRow> bench_restarts(const std::function<std::unique_ptr<ISolution>()>& makeSol,
+                                            const std::function<std::unique_ptr<IMutation>()>& makeMut,
+                                            const std::function<std::unique_ptr<ITempSchedule>()>& makeTemp,
+                                            SAParams p, size_t runs) {
+    struct Cfg { const char* name; RestartPolicy pol; };
+    const Cfg cfgs[] = {{"reheat", RestartPolicy::Reheat},
+                        {"perturb-best", RestartPolicy::PerturbBest},
+                        {"fresh-seed", RestartPolicy::FreshSeed},
+                        {"independent", RestartPolicy::None}};
+    std::vector<RestartBenchRow> rows;
+    for (const auto& cfg : cfgs) {
+        RestartBenchRow row{cfg.name, INFINITY, 0.0, 0.0};
+        for (size_t r = 0; r < runs; ++r) {
+            SAParams q = p;
+            q.seed = p.seed + r * 7919;
+            q.restart = cfg.pol;
+            double best = INFINITY;
+            size_t nrest = 0;
+            if (cfg.pol == RestartPolicy::None) {
+                // обычное ИО до застоя, снова и снова с новым стартом, пока есть бюджет
+                const auto t0 = Clock::now();
+                std::mt19937_64 rng(q.seed);
+                do {
+                    auto s = makeSol();
+                    s->randomize(rng);
+                    q.seed = rng();
+                    SimulatedAnnealing e(std::move(s), makeMut(), makeTemp(), q);
+                    best = std::min(best, e.run()->objective());
+                    ++nrest;
+                } while (since(t0) < p.timeBudgetSec);
+                --nrest;
+            } else {
+                std::mt19937_64 rng(q.seed);
+                auto s = makeSol();
+                s->randomize(rng);
+                RestartingAnnealer e(std::move(s), makeMut(), makeTemp(), q);
+                best = e.run()->objective();
+                nrest = e.restarts();
+            }
+            row.bestObj = std::min(row.bestObj, best);
+            row.meanObj += best / double(runs);
+            row.meanRestarts += double(nrest) / double(runs);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+void print_restart_bench(const std::vector<RestartBenchRow>& rows) {
+    std::printf("%-14s %16s %16s %10s\n", "policy", "best", "mean", "restarts");
+    for (const auto& r : rows)
+        std::printf("%-14s %16.1f %16.1f %10.1f\n", r.name, r.bestObj, r.meanObj, r.meanRestarts);
+}
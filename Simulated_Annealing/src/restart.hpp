@@ -0,0 +1,43 @@
+#pragma once
+#include "sa.hpp"
+#include <functional>
+
+// ИО с рестартами: вместо выхода по застою тратит остаток timeBudgetSec.
+// Застой — обвал доли принятых ходов (minAcceptRate, collapseLevels уровней подряд),
+// исчерпание patienceK или T < Tmin. Политики (SAParams::restart):
+//   Reheat      — T = reheatFrac * T0, продолжаем с текущего;
+//   PerturbBest — с лучшего, после perturbMoves мутаций, T = reheatFrac * T0;
+//   FreshSeed   — новый старт: randomize (для ScheduleSolution чередуем со SPT-упорядочиванием), T = T0.
+class RestartingAnnealer : public ISearchEngine {
+public:
+    RestartingAnnealer(std::unique_ptr<ISolution> init,
+                       std::unique_ptr<IMutation> mut,
+                       std::unique_ptr<ITempSchedule> temp,
+                       SAParams p);
+    std::unique_ptr<ISolution> run() override;
+    size_t restarts() const { return restarts_; }
+    // С -DSA_PROFILE run() меряет фазы Move/Evaluate/Accept и печатает отчёт в конце
+    const PhaseProfiler& profile() const { return prof_; }
+private:
+    void restart();
+    std::unique_ptr<ISolution> cur_, best_;
+    std::unique_ptr<IMutation> mut_;
+    std::unique_ptr<ITempSchedule> temp_;
+    SAParams P_;
+    std::mt19937_64 rng_;
+    size_t restarts_{0};
+    PhaseProfiler prof_;
+};
+
+// Сравнение политик с независимыми перезапусками обычного ИО в том же бюджете времени.
+// Фабрики нужны, потому что каждый прогон владеет своими мутацией и расписанием.
+struct RestartBenchRow {
+    const char* name;
+    double bestObj, meanObj;
+    double meanRestarts;
+};
+std::vector<RestartBenchRow> bench_restarts(const std::function<std::unique_ptr<ISolution>()>& makeSol,
+                                            const std::function<std::unique_ptr<IMutation>()>& makeMut,
+                                            const std::function<std::unique_ptr<ITempSchedule>()>& makeTemp,
+                                            SAParams p, size_t runs);
+void print_restart_bench(const std::vector<RestartBenchRow>& rows);
@@ -2,12 +2,34 @@
 #include <memory>
 #include <vector>
 #include <random>
+#include "perf_counters.hpp" // SA_PROF_* пустые без -DSA_PROFILE
+
+enum class EngineKind : uint8_t { SA, LAHC, TA }; // см. engines.hpp
+enum class ObjectiveKind : uint8_t { K2, Makespan, Blend }; // см. objective.hpp
+enum class RestartPolicy : uint8_t { None, Reheat, PerturbBest, FreshSeed }; // см. restart.hpp
 
 struct SAParams {
     double T0{1.0}, Tmin{1e-3};
     size_t itersPerT{100};
     size_t patienceK{100}; // seq: 100 без улучшений (параллельный задаст своё)
     uint64_t seed{42};
+    bool polish{false};    // run_sequential/run_parallel: polish_schedule() над лучшим (polish.hpp)
+    EngineKind engine{EngineKind::SA};
+    size_t lahcLength{50}; // LAHC: длина истории
+    double target{-1.0};   // >=0: стоп, как только objective <= target (замер time-to-target)
+    ObjectiveKind objective{ObjectiveKind::K2};
+    double wK2{1.0}, wCmax{0.0}; // Blend: wK2 * K2 + wCmax * Cmax
+    // Рестарты при застое (доля принятых < minAcceptRate collapseLevels уровней подряд,
+    // либо кончилась patienceK / T < Tmin), пока не исчерпан timeBudgetSec (0 — без рестартов)
+    RestartPolicy restart{RestartPolicy::None};
+    double timeBudgetSec{0.0};
+    double reheatFrac{0.3};     // Reheat: T = reheatFrac * T0
+    size_t perturbMoves{20};    // PerturbBest: столько мутаций над лучшим
+    double minAcceptRate{1e-3};
+    size_t collapseLevels{3};
+    // Пакетный шаг (batched.hpp): batchK кандидатов за шаг, один принимается
+    size_t batchK{1};
+    bool rejectionFree{false}; // n-fold way вместо Метрополиса по очереди
 };
 
 struct ISolution {
@@ -23,6 +45,9 @@ struct ISolution {
 struct IMutation {
     virtual ~IMutation() = default;
     virtual void apply(ISolution& s, std::mt19937_64& rng) = 0;
+    // Движок сообщает результат последнего apply: delta = objective(кандидат) - objective(текущее),
+    // которую он и так посчитал для приёма. Нужна адаптивным мутациям, остальным — no-op
+    virtual void feedback(double /*delta*/) {}
 };
 
 struct ITempSchedule {
@@ -32,17 +57,37 @@ struct ITempSchedule {
     virtual void next() = 0;
 };
 
-class SimulatedAnnealing {
+struct EngineStats {
+    uint64_t iters{0}, accepted{0};
+    double secToTarget{-1.0}; // <0: цель не достигнута
+};
+
+// Общий вход для ИО и альтернативных движков (engines.hpp)
+class ISearchEngine {
+public:
+    virtual ~ISearchEngine() = default;
+    virtual std::unique_ptr<ISolution> run() = 0; // возвращает лучшее найденное
+    const EngineStats& stats() const { return stats_; }
+protected:
+    EngineStats stats_;
+};
+
+class SimulatedAnnealing : public ISearchEngine {
 public:
     SimulatedAnnealing(std::unique_ptr<ISolution> init,
                        std::unique_ptr<IMutation> mut,
                        std::unique_ptr<ITempSchedule> temp,
                        SAParams p);
-    std::unique_ptr<ISolution> run(); // возвращает лучшее найденное
+    std::unique_ptr<ISolution> run() override; // возвращает лучшее найденное
+    // Реализация run() (вне этого дерева) должна оборачивать фазы в SA_PROF_SCOPE(prof_, SAPhase::...)
+    // и в конце звать SA_PROF_REPORT(prof_), как это делает RestartingAnnealer::run; без -DSA_PROFILE
+    // prof_ не трогается (член есть всегда — раскладка не зависит от флага)
+    const PhaseProfiler& profile() const { return prof_; }
 private:
     std::unique_ptr<ISolution> cur_, best_;
     std::unique_ptr<IMutation> mut_;
     std::unique_ptr<ITempSchedule> temp_;
     SAParams P_;
     std::mt19937_64 rng_;
+    PhaseProfiler prof_;
 };
\ No newline at end of file
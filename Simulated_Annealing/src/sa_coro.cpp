@@ -0,0 +1,115 @@
+#include "sa_coro.hpp"
+#include <cmath>
+#include <limits>
+
+SARun anneal_steps(std::unique_ptr<ISolution> cur,
+                   std::unique_ptr<IMutation> mut,
+                   std::unique_ptr<ITempSchedule> temp,
+                   SAParams P) {
+    std::mt19937_64 rng(P.seed);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::unique_ptr<ISolution> best = cur->clone();
+    double curObj = cur->objective(), bestObj = curObj;
+    SAStep st;
+    size_t noImprove = 0;
+
+    temp->reset(P.T0);
+    while (temp->current() > P.Tmin && noImprove < P.patienceK) {
+        const double T = temp->current();
+        bool improved = false;
+        for (size_t k = 0; k < P.itersPerT; ++k) {
+            auto cand = cur->clone();
+            mut->apply(*cand, rng);
+            double candObj = cand->objective();
+            double d = candObj - curObj;
+            mut->feedback(d);
+            ++st.iters;
+            if (d <= 0 || U(rng) < std::exp(-d / T)) {
+                cur = std::move(cand);
+                curObj = candObj;
+                ++st.accepted;
+                if (curObj < bestObj) {
+                    best = cur->clone();
+                    bestObj = curObj;
+                    improved = true;
+                }
+            }
+        }
+        noImprove = improved ? 0 : noImprove + 1;
+
+        st.T = T;
+        st.cur = curObj;
+        st.best = bestObj;
+        st.bestSol = best.get();
+        co_yield st;
+        ++st.level;
+        temp->next();
+    }
+    co_return std::move(best);
+}
+
+size_t SAScheduler::add(SARun r) {
+    slots.push_back(Slot{std::move(r)});
+    return slots.size() - 1;
+}
+
+size_t SAScheduler::leader_index() const {
+    size_t L = slots.size();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const Slot& s = slots[i];
+        if (!s.dropped && s.steps > 0 && (L == slots.size() || s.last.best < slots[L].last.best)) L = i;
+    }
+    return L;
+}
+
+const SAScheduler::Slot* SAScheduler::leader() const {
+    size_t L = leader_index();
+    return L < slots.size() ? &slots[L] : nullptr;
+}
+
+size_t SAScheduler::run(uint64_t maxSlices) {
+    size_t done = 0;
+    for (; done < maxSlices; ++done) {
+        // выбор: сначала недобравшие minSteps, затем по кругу среди выживших —
+        // иначе квант всегда доставался бы одному лидеру, а best остальных устаревал
+        Slot* pick = nullptr;
+        for (auto& s : slots) {
+            if (!active(s)) continue;
+            if (!pick) { pick = &s; continue; }
+            bool sYoung = s.steps < minSteps, pYoung = pick->steps < minSteps;
+            if (sYoung != pYoung) { if (sYoung) pick = &s; continue; }
+            if (sYoung) {
+                if (s.steps < pick->steps) pick = &s;
+            } else if (s.lastSlice != pick->lastSlice ? s.lastSlice < pick->lastSlice : s.last.best < pick->last.best) {
+                pick = &s;
+            }
+        }
+        if (!pick) break;
+
+        if (pick->run.next()) pick->last = pick->run.step();
+        ++pick->steps;
+        pick->lastSlice = ++slice_;
+
+        const Slot* L = leader();
+        if (!L) continue;
+        const double bar = L->last.best + std::abs(L->last.best) * dropRatio;
+        for (auto& s : slots) {
+            if (&s == L || !active(s) || s.steps < minSteps || s.last.best <= bar) continue;
+            s.dropped = true;
+            s.run = SARun{nullptr}; // кадр корутины освобождаем сразу
+        }
+    }
+    return done;
+}
+
+std::unique_ptr<ISolution> SAScheduler::take_best() {
+    size_t i = leader_index();
+    if (i == slots.size()) return nullptr;
+    Slot& L = slots[i];
+    // результат не забираем: last.bestSol смотрит на тот же объект и должен остаться живым
+    if (L.run.done()) {
+        const ISolution* r = L.run.result();
+        return r ? r->clone() : nullptr;
+    }
+    return L.last.bestSol ? L.last.bestSol->clone() : nullptr;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "sa.hpp"
+#include <coroutine>
+#include <exception>
+
+// Возобновляемый ИО: корутина отдаёт управление после каждого температурного уровня.
+// Один поток может чередовать сотни прогонов (SAScheduler), без переключений контекста ОС.
+struct SAStep {
+    size_t level{0};
+    double T{0.0};
+    double cur{0.0}, best{0.0};           // критерий текущего и лучшего
+    uint64_t iters{0}, accepted{0};       // накопительно
+    const ISolution* bestSol{nullptr};    // действителен до следующего resume
+};
+
+class SARun {
+public:
+    struct promise_type {
+        SAStep step;
+        std::unique_ptr<ISolution> result;
+        SARun get_return_object() { return SARun{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const SAStep& s) { step = s; return {}; }
+        void return_value(std::unique_ptr<ISolution> best) { result = std::move(best); }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit SARun(std::coroutine_handle<promise_type> h) : h_(h) {}
+    SARun(SARun&& o) noexcept : h_(o.h_) { o.h_ = nullptr; }
+    SARun& operator=(SARun&& o) noexcept {
+        if (this != &o) { if (h_) h_.destroy(); h_ = o.h_; o.h_ = nullptr; }
+        return *this;
+    }
+    SARun(const SARun&) = delete;
+    SARun& operator=(const SARun&) = delete;
+    ~SARun() { if (h_) h_.destroy(); }
+
+    bool next() { if (!done()) h_.resume(); return !done(); } // один температурный уровень
+    bool done() const { return !h_ || h_.done(); }
+    const SAStep& step() const { return h_.promise().step; }
+    std::unique_ptr<ISolution> take_result() { return done() && h_ ? std::move(h_.promise().result) : nullptr; }
+    // Итог без передачи владения; nullptr, пока прогон не закончен или после take_result
+    const ISolution* result() const { return done() && h_ ? h_.promise().result.get() : nullptr; }
+
+private:
+    std::coroutine_handle<promise_type> h_;
+};
+
+// Тот же цикл, что в SimulatedAnnealing::run, но с co_yield после каждого уровня
+SARun anneal_steps(std::unique_ptr<ISolution> init,
+                   std::unique_ptr<IMutation> mut,
+                   std::unique_ptr<ITempSchedule> temp,
+                   SAParams p);
+
+// Кооперативный планировщик: новички сначала добирают minSteps уровней, затем кванты
+// идут по кругу между выжившими (дольше всех ждавший первым, при равенстве — лучший best);
+// отстающие от лидера больше чем на dropRatio снимаются и уничтожаются, так что круг —
+// это и есть полоса [best лидера, best лидера * (1 + dropRatio)].
+class SAScheduler {
+public:
+    struct Slot {
+        SARun run;
+        SAStep last{};
+        size_t steps{0};
+        uint64_t lastSlice{0}; // номер кванта, в котором прогон последний раз возобновлялся
+        bool dropped{false};
+    };
+
+    size_t add(SARun r);
+    size_t run(uint64_t maxSlices);        // возвращает число выполненных квантов
+    const Slot* leader() const;
+    std::unique_ptr<ISolution> take_best(); // копия лучшего решения лидера; можно звать сколько угодно раз
+
+    size_t minSteps{5};
+    double dropRatio{0.05};
+    std::vector<Slot> slots;
+
+private:
+    bool active(const Slot& s) const { return !s.dropped && !s.run.done(); }
+    size_t leader_index() const; // slots.size(), если лидера нет
+    uint64_t slice_{0};
+};
@@ -0,0 +1,165 @@
+#include "io.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+constexpr char kMagic[4] = {'S', 'A', 'S', 'C'};
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+    char magic[4];
+    uint32_t version, N, M;
+    uint64_t K2, reserved;
+};
+struct ProcEntry {
+    uint64_t first, load; // first — индекс первой работы процессора в массивах C/job
+    uint32_t count, reserved;
+};
+static_assert(sizeof(Header) == 32 && sizeof(ProcEntry) == 24);
+
+// Буфер на chunkBytes, сбрасывается в файл целиком.
+// Пишет в path.tmp и переименовывает в path только в finish(); при любой ошибке
+// (или если finish() не позвали) .tmp удаляется и старый path остаётся нетронутым
+class ChunkWriter {
+public:
+    ChunkWriter(const std::string& path, size_t chunk)
+        : path_(path), tmp_(path + ".tmp"), f_(std::fopen(tmp_.c_str(), "wb")) {
+        buf_.reserve(std::max<size_t>(chunk, 4096));
+        created_ = f_ != nullptr;
+    }
+    ~ChunkWriter() {
+        if (f_) std::fclose(f_);
+        if (created_ && !done_) ::unlink(tmp_.c_str());
+    }
+    bool ok() const { return f_ && ok_; }
+    void put(const void* p, size_t n) {
+        const uint8_t* b = static_cast<const uint8_t*>(p);
+        while (n > 0) {
+            size_t k = std::min(n, buf_.capacity() - buf_.size());
+            buf_.insert(buf_.end(), b, b + k);
+            b += k; n -= k;
+            if (buf_.size() == buf_.capacity()) flush();
+        }
+    }
+    template <class T> void pod(const T& v) { put(&v, sizeof(T)); }
+    void text(const char* s, int n) { if (n > 0) put(s, size_t(n)); }
+    bool finish() {
+        if (!f_) return false;
+        flush();
+        bool res = ok_ && std::fclose(f_) == 0;
+        f_ = nullptr;
+        done_ = res && std::rename(tmp_.c_str(), path_.c_str()) == 0;
+        return done_;
+    }
+private:
+    void flush() {
+        if (f_ && !buf_.empty() && std::fwrite(buf_.data(), 1, buf_.size(), f_) != buf_.size()) ok_ = false;
+        buf_.clear();
+    }
+    std::string path_, tmp_;
+    std::FILE* f_;
+    std::vector<uint8_t> buf_;
+    bool ok_{true}, created_{false}, done_{false};
+};
+} // namespace
+
+bool write_schedule_bin(const std::string& path, const ScheduleSolution& S, size_t chunkBytes) {
+    const Instance& I = *S.inst_;
+    ChunkWriter w(path, chunkBytes);
+    if (!w.ok()) return false;
+
+    Header h{};
+    std::memcpy(h.magic, kMagic, 4);
+    h.version = kVersion;
+    h.N = I.N;
+    h.M = uint32_t(S.G.size());
+    h.K2 = evalK2(S);
+    w.pod(h);
+
+    uint64_t first = 0;
+    for (const auto& Gj : S.G) {
+        ProcEntry e{first, 0, uint32_t(Gj.size()), 0};
+        for (uint32_t i : Gj) e.load += I.t[i];
+        w.pod(e);
+        first += Gj.size();
+    }
+    for (const auto& Gj : S.G) {
+        uint64_t acc = 0;
+        for (uint32_t i : Gj) { acc += I.t[i]; w.pod(acc); }
+    }
+    for (const auto& Gj : S.G)
+        for (uint32_t i : Gj) w.pod(i);
+    return first == I.N && w.finish();
+}
+
+bool write_schedule_csv(const std::string& path, const ScheduleSolution& S, size_t chunkBytes) {
+    const Instance& I = *S.inst_;
+    ChunkWriter w(path, chunkBytes);
+    if (!w.ok()) return false;
+    char line[96];
+    w.text(line, std::snprintf(line, sizeof(line), "# K2=%llu,N=%u,M=%zu\nproc,pos,job,t,completion\n",
+                               (unsigned long long)evalK2(S), I.N, S.G.size()));
+    for (size_t j = 0; j < S.G.size(); ++j) {
+        uint64_t acc = 0, pos = 0;
+        for (uint32_t i : S.G[j]) {
+            acc += I.t[i];
+            w.text(line, std::snprintf(line, sizeof(line), "%zu,%llu,%u,%u,%llu\n", j,
+                                       (unsigned long long)pos++, i, I.t[i], (unsigned long long)acc));
+        }
+    }
+    return w.finish();
+}
+
+bool ScheduleFileView::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) { ::close(fd); return false; }
+    void* p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+    base_ = static_cast<const uint8_t*>(p);
+    size_ = size_t(st.st_size);
+
+    Header h;
+    std::memcpy(&h, base_, sizeof(h));
+    const size_t need = sizeof(Header) + size_t(h.M) * sizeof(ProcEntry) + size_t(h.N) * (sizeof(uint64_t) + sizeof(uint32_t));
+    if (std::memcmp(h.magic, kMagic, 4) != 0 || h.version != kVersion || size_ != need) { close(); return false; }
+    N_ = h.N; M_ = h.M; K2_ = h.K2;
+    for (uint32_t q = 0; q < M_; ++q) { // записи не должны выводить за массивы
+        const auto* e = reinterpret_cast<const ProcEntry*>(base_ + sizeof(Header)) + q;
+        if (e->first > N_ || e->count > N_ - e->first) { close(); return false; }
+    }
+    return true;
+}
+
+void ScheduleFileView::close() {
+    if (base_) ::munmap(const_cast<uint8_t*>(base_), size_);
+    base_ = nullptr;
+    size_ = 0;
+    N_ = M_ = 0;
+    K2_ = 0;
+}
+
+uint64_t ScheduleFileView::load(uint32_t p) const {
+    return reinterpret_cast<const ProcEntry*>(base_ + sizeof(Header))[p].load;
+}
+
+std::span<const uint64_t> ScheduleFileView::completion(uint32_t p) const {
+    const auto& e = reinterpret_cast<const ProcEntry*>(base_ + sizeof(Header))[p];
+    const auto* C = reinterpret_cast<const uint64_t*>(base_ + sizeof(Header) + size_t(M_) * sizeof(ProcEntry));
+    return {C + e.first, e.count};
+}
+
+std::span<const uint32_t> ScheduleFileView::jobs(uint32_t p) const {
+    const auto& e = reinterpret_cast<const ProcEntry*>(base_ + sizeof(Header))[p];
+    const auto* J = reinterpret_cast<const uint32_t*>(base_ + sizeof(Header) + size_t(M_) * sizeof(ProcEntry) +
+                                                      size_t(N_) * sizeof(uint64_t));
+    return {J + e.first, e.count};
+}
@@ -0,0 +1,82 @@
+#include "stats.hpp"
+#include <cstdio>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+MasterStats::MasterStats(uint32_t nproc) : lastImprove_(Clock::now()), workers_(nproc) {}
+
+void MasterStats::on_global_best(double obj) {
+    if (haveBest_ && obj >= globalBest_) return;
+    globalBest_ = obj;
+    haveBest_ = true;
+    lastImprove_ = Clock::now();
+}
+
+void MasterStats::on_outer_iteration(bool improved) {
+    outerNoImprove_ = improved ? 0 : outerNoImprove_ + 1;
+}
+
+void MasterStats::on_progress(const WorkerProgress& p) {
+    if (p.rank >= workers_.size()) workers_.resize(p.rank + 1);
+    Worker& w = workers_[p.rank];
+    auto now = Clock::now();
+    if (w.any && p.iters >= w.last.iters) {
+        double dt = std::chrono::duration<double>(now - w.seen).count();
+        if (dt > 0) w.itersPerSec = double(p.iters - w.last.iters) / dt;
+    }
+    w.last = p;
+    w.seen = now;
+    w.any = true;
+}
+
+std::string MasterStats::to_json() const {
+    char buf[160];
+    std::string out = "{\"globalBest\":";
+    if (haveBest_) { std::snprintf(buf, sizeof(buf), "%.17g", globalBest_); out += buf; }
+    else out += "null";
+    std::snprintf(buf, sizeof(buf), ",\"sinceImprovementSec\":%.3f,\"outerNoImprove\":%llu,\"workers\":[",
+                  std::chrono::duration<double>(Clock::now() - lastImprove_).count(),
+                  (unsigned long long)outerNoImprove_);
+    out += buf;
+    for (size_t r = 0; r < workers_.size(); ++r) {
+        const Worker& w = workers_[r];
+        if (w.any)
+            std::snprintf(buf, sizeof(buf), "%s{\"rank\":%zu,\"itersPerSec\":%.1f,\"T\":%.17g,\"best\":%.17g}",
+                          r ? "," : "", r, w.itersPerSec, w.last.T, w.last.best);
+        else
+            std::snprintf(buf, sizeof(buf), "%s{\"rank\":%zu,\"itersPerSec\":null,\"T\":null,\"best\":null}",
+                          r ? "," : "", r);
+        out += buf;
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool is_stats_request(const uint8_t* p, size_t n) {
+    const size_t k = sizeof(kStatsRequest) - 1;
+    return n >= k && std::memcmp(p, kStatsRequest, k) == 0;
+}
+
+bool answer_stats(int fd, const MasterStats& s) {
+    const std::string js = s.to_json();
+    ssize_t w = ::send(fd, js.data(), js.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    return w == ssize_t(js.size());
+}
+
+std::string query_stats(const std::string& sockPath) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return {};
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, sockPath.c_str(), sizeof(addr.sun_path) - 1);
+    std::string out;
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 &&
+        ::send(fd, kStatsRequest, sizeof(kStatsRequest) - 1, MSG_NOSIGNAL) > 0) {
+        char buf[4096];
+        for (ssize_t n; (n = ::read(fd, buf, sizeof(buf))) > 0;) out.append(buf, size_t(n));
+    }
+    ::close(fd);
+    return out;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Живые метрики мастера run_parallel. Клиент подключается к тому же PF_UNIX-сокету
+// и первым сообщением шлёт "STATS"; мастер отвечает JSON из уже посчитанных счётчиков
+// неблокирующей отправкой и закрывает соединение — обмен BEST этим не задерживается.
+//
+// {"globalBest":..,"sinceImprovementSec":..,"outerNoImprove":..,
+//  "workers":[{"rank":0,"itersPerSec":..,"T":..,"best":..},...]}
+
+inline constexpr char kStatsRequest[] = "STATS";
+
+// Воркер прикладывает к BEST (и шлёт отдельно раз в уровень)
+struct WorkerProgress {
+    uint32_t rank{0};
+    uint64_t iters{0}; // накопительно
+    double T{0.0};
+    double best{0.0};
+};
+
+class MasterStats {
+public:
+    explicit MasterStats(uint32_t nproc);
+    void on_global_best(double obj);           // globalBest улучшен
+    void on_outer_iteration(bool improved);
+    void on_progress(const WorkerProgress& p); // it/s = Δiters / Δt между сообщениями
+    std::string to_json() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Worker {
+        WorkerProgress last{};
+        Clock::time_point seen{};
+        double itersPerSec{0.0};
+        bool any{false};
+    };
+    double globalBest_{0.0};
+    bool haveBest_{false};
+    Clock::time_point lastImprove_;
+    uint64_t outerNoImprove_{0};
+    std::vector<Worker> workers_;
+};
+
+bool is_stats_request(const uint8_t* p, size_t n);
+// Отправка без блокировки: медленный клиент просто не дочитает ответ
+bool answer_stats(int fd, const MasterStats& s);
+// Клиентская сторона (для оператора): "" при ошибке
+std::string query_stats(const std::string& sockPath);